@@ -39,6 +39,7 @@
 
 #include <graphene/utilities/key_conversion.hpp>
 #include <graphene/utilities/git_revision.hpp>
+#include <graphene/utilities/tracer.hpp>
 #include <fc/git_revision.hpp>
 
 #include <fc/smart_ref_impl.hpp>
@@ -333,6 +334,27 @@ public:
                 _shared_dir = _data_dir / "blockchain";
             }
 
+            _chain_db->set_block_cache_size(_options->at("block-cache-size").as<uint32_t>());
+            _chain_db->set_block_log_segment_size(_options->at("block-log-segment-blocks").as<uint32_t>());
+            _chain_db->set_block_log_retain_blocks(_options->at("block-log-retain-blocks").as<uint32_t>());
+            _chain_db->set_slow_block_threshold(_options->at("slow-block-threshold").as<uint32_t>());
+
+            const uint32_t trace_buffer_size = _options->at("trace-buffer-size").as<uint32_t>();
+            if (trace_buffer_size != 0)
+            {
+                fc::path trace_dir = fc::path(_options->at("trace-dir").as<boost::filesystem::path>());
+                if (trace_dir.is_relative())
+                    trace_dir = _data_dir / trace_dir;
+
+                graphene::utilities::tracer::instance().start(trace_buffer_size, trace_dir);
+                ilog("Tracing last ${n} spans to ${d}", ("n", trace_buffer_size)("d", trace_dir));
+            }
+
+            if (_options->count("profile-operations"))
+            {
+                _chain_db->set_operation_profile_interval(_options->at("profile-operations").as<uint32_t>());
+            }
+
             if (_options->count("disable_get_block"))
             {
                 _self->_disable_get_block = true;
@@ -578,10 +600,20 @@ public:
                     // you can help the network code out by throwing a block_older_than_undo_history exception.
                     // when the net code sees that, it will stop trying to push blocks from that chain, but
                     // leave that peer connected so that they can get sync blocks from us
-                    bool result = _chain_db->push_block(blk_msg.block,
-                                                        (_is_block_producer | _force_validate)
-                                                            ? database::skip_nothing
-                                                            : database::skip_transaction_signatures);
+                    uint32_t skip = (_is_block_producer | _force_validate) ? database::skip_nothing
+                                                                            : database::skip_transaction_signatures;
+
+                    graphene::utilities::trace_scope trace("handle_block", "app", blk_msg.block.block_num());
+
+                    // stateless checks and signature key recovery are done here, so they do not hold the write lock
+                    database::prevalidated_block prevalidated;
+                    {
+                        graphene::utilities::trace_scope prevalidate_trace("prevalidate_block", "app",
+                                                                           blk_msg.block.block_num());
+                        prevalidated = database::prevalidate_block(blk_msg.block, _chain_db->get_chain_id(), skip);
+                    }
+
+                    bool result = _chain_db->push_block(blk_msg.block, prevalidated, skip);
 
                     if (!sync_mode)
                     {
@@ -728,14 +760,14 @@ public:
             if (id.item_type == graphene::net::block_message_type)
             {
                 return _chain_db->with_read_lock([&]() {
-                    auto opt_block = _chain_db->fetch_block_by_id(id.item_hash);
+                    auto opt_block = _chain_db->fetch_shared_block_by_id(id.item_hash);
                     if (!opt_block)
                         elog("Couldn't find block ${id} -- corresponding ID in our chain is ${id2}",
                              ("id", id.item_hash)(
                                  "id2", _chain_db->get_block_id_for_num(block_header::num_from_id(id.item_hash))));
-                    FC_ASSERT(opt_block.valid());
+                    FC_ASSERT(opt_block);
                     // ilog("Serving up block #${num}", ("num", opt_block->block_num()));
-                    return block_message(std::move(*opt_block));
+                    return block_message(*opt_block);
                 });
             }
             return _chain_db->with_read_lock(
@@ -990,10 +1022,10 @@ public:
         try
         {
             return _chain_db->with_read_lock([&]() {
-                auto opt_block = _chain_db->fetch_block_by_id(block_id);
-                if (opt_block.valid())
+                auto opt_header = _chain_db->fetch_block_header_by_id(block_id);
+                if (opt_header.valid())
                 {
-                    return opt_block->timestamp;
+                    return opt_header->timestamp;
                 }
                 return fc::time_point_sec::min();
             });
@@ -1121,6 +1153,13 @@ void application::set_program_options(boost::program_options::options_descriptio
     ("enable-plugin", bpo::value< std::vector<std::string> >()->composing()->default_value(default_plugins, str_default_plugins), "Plugin(s) to enable, may be specified multiple times")
     ("max-block-age", bpo::value< int32_t >()->default_value(200), "Maximum age of head block when broadcasting tx via API")
     ("flush", bpo::value< uint32_t >()->default_value(100000), "Flush shared memory file to disk this many blocks")
+    ("block-cache-size", bpo::value< uint32_t >()->default_value(scorum::chain::block_cache::default_capacity), "Number of recently accessed blocks kept decoded in memory, 0 to disable")
+    ("block-log-segment-blocks", bpo::value< uint32_t >()->default_value(0), "Start a new block log segment file every this many blocks, 0 to keep a single file")
+    ("block-log-retain-blocks", bpo::value< uint32_t >()->default_value(0), "Remove block log segments older than this many irreversible blocks on shared memory flush, 0 to keep the full history")
+    ("slow-block-threshold", bpo::value< uint32_t >()->default_value(1000), "Log time of block application phases for blocks which took longer than this many milliseconds, 0 to disable")
+    ("trace-buffer-size", bpo::value< uint32_t >()->default_value(0), "Record this many most recent block processing spans for Chrome trace export, 0 to disable tracing")
+    ("trace-dir", bpo::value<boost::filesystem::path>()->default_value("traces"), "Directory for trace dumps of slow blocks and of debug_node_api requests, relative to data-dir")
+    ("profile-operations", bpo::value< uint32_t >(), "Profile execution time of operations by type and log the profile every this many blocks, 0 to profile without logging")
     ("genesis-json,g", bpo::value<boost::filesystem::path>(), "File to read genesis state from");
     command_line_options.add(configuration_file_options);
     command_line_options.add_options()
@@ -4,6 +4,7 @@
 
 #include <scorum/protocol/get_config.hpp>
 
+#include <scorum/chain/history_store.hpp>
 #include <scorum/chain/schema/registration_objects.hpp>
 #include <scorum/chain/schema/proposal_object.hpp>
 #include <scorum/chain/util/reward.hpp>
@@ -44,8 +45,14 @@ public:
 
     // Blocks and transactions
     optional<block_header> get_block_header(uint32_t block_num) const;
+    std::vector<block_header_record>
+    get_block_headers_by_time(time_point_sec start, time_point_sec end, uint32_t limit) const;
     optional<signed_block_api_obj> get_block(uint32_t block_num) const;
     std::vector<applied_operation> get_ops_in_block(uint32_t block_num, bool only_virtual) const;
+    block_cache_stats get_block_cache_stats() const;
+    mempool_stats get_mempool_stats() const;
+    block_timing_stats get_block_timing_stats() const;
+    async_indexer_stats get_async_indexer_stats() const;
 
     // Globals
     fc::variant_object get_config() const;
@@ -118,6 +125,17 @@ applied_operation::applied_operation(const operation_object& op_obj)
     op = fc::raw::unpack<operation>(op_obj.serialized_op);
 }
 
+applied_operation::applied_operation(const indexed_operation& indexed_op)
+    : trx_id(indexed_op.trx_id)
+    , block(indexed_op.block)
+    , trx_in_block(indexed_op.trx_in_block)
+    , op_in_trx(indexed_op.op_in_trx)
+    , virtual_op(indexed_op.virtual_op)
+    , timestamp(indexed_op.timestamp)
+    , op(indexed_op.op)
+{
+}
+
 void find_accounts(std::set<std::string>& accounts, const discussion& d)
 {
     accounts.insert(d.author);
@@ -209,10 +227,22 @@ optional<block_header> database_api::get_block_header(uint32_t block_num) const
 
 optional<block_header> database_api_impl::get_block_header(uint32_t block_num) const
 {
-    auto result = _db.fetch_block_by_number(block_num);
-    if (result)
-        return *result;
-    return {};
+    return _db.fetch_block_header_by_number(block_num);
+}
+
+std::vector<block_header_record>
+database_api::get_block_headers_by_time(time_point_sec start, time_point_sec end, uint32_t limit) const
+{
+    FC_ASSERT(!my->_disable_get_block, "get_block_headers_by_time is disabled on this node.");
+    FC_ASSERT(limit <= 1000);
+
+    return my->_db.with_read_lock([&]() { return my->get_block_headers_by_time(start, end, limit); });
+}
+
+std::vector<block_header_record>
+database_api_impl::get_block_headers_by_time(time_point_sec start, time_point_sec end, uint32_t limit) const
+{
+    return _db.fetch_block_headers_by_time(start, end, limit);
 }
 
 optional<signed_block_api_obj> database_api::get_block(uint32_t block_num) const
@@ -224,7 +254,13 @@ optional<signed_block_api_obj> database_api::get_block(uint32_t block_num) const
 
 optional<signed_block_api_obj> database_api_impl::get_block(uint32_t block_num) const
 {
-    return _db.fetch_block_by_number(block_num);
+    optional<signed_block_api_obj> result;
+
+    auto b = _db.fetch_shared_block_by_number(block_num);
+    if (b)
+        result = signed_block_api_obj(*b);
+
+    return result;
 }
 
 std::vector<applied_operation> database_api::get_ops_in_block(uint32_t block_num, bool only_virtual) const
@@ -234,6 +270,18 @@ std::vector<applied_operation> database_api::get_ops_in_block(uint32_t block_num
 
 std::vector<applied_operation> database_api_impl::get_ops_in_block(uint32_t block_num, bool only_virtual) const
 {
+    auto store = _db.get_history_store();
+    if (store)
+    {
+        std::vector<applied_operation> result;
+        for (const indexed_operation& op : store->get_ops_in_block(block_num))
+        {
+            if (!only_virtual || is_virtual_operation(op.op))
+                result.push_back(op);
+        }
+        return result;
+    }
+
     const auto& idx = _db.get_index<operation_index>().indices().get<by_location>();
     auto itr = idx.lower_bound(block_num);
     std::vector<applied_operation> result;
@@ -248,6 +296,47 @@ std::vector<applied_operation> database_api_impl::get_ops_in_block(uint32_t bloc
     return result;
 }
 
+block_cache_stats database_api::get_block_cache_stats() const
+{
+    return my->_db.with_read_lock([&]() { return my->get_block_cache_stats(); });
+}
+
+block_cache_stats database_api_impl::get_block_cache_stats() const
+{
+    return _db.get_block_cache_stats();
+}
+
+mempool_stats database_api::get_mempool_stats() const
+{
+    return my->_db.with_read_lock([&]() { return my->get_mempool_stats(); });
+}
+
+mempool_stats database_api_impl::get_mempool_stats() const
+{
+    return _db.get_mempool_stats();
+}
+
+block_timing_stats database_api::get_block_timing_stats() const
+{
+    return my->_db.with_read_lock([&]() { return my->get_block_timing_stats(); });
+}
+
+block_timing_stats database_api_impl::get_block_timing_stats() const
+{
+    return _db.get_block_timing_stats();
+}
+
+async_indexer_stats database_api::get_async_indexer_stats() const
+{
+    // consumers are not a part of the chain state, there is no need to wait for the block being applied
+    return my->get_async_indexer_stats();
+}
+
+async_indexer_stats database_api_impl::get_async_indexer_stats() const
+{
+    return _db.get_async_indexer_stats();
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Globals                                                          //
@@ -1026,7 +1115,7 @@ std::vector<budget_api_obj> database_api_impl::get_budgets(const std::set<std::s
 
         for (const chain::budget_object& budget : budgets)
         {
-            results.push_back(budget_api_obj(budget));
+            results.push_back(budget_api_obj(budget, _db.head_block_num()));
         }
     }
 
@@ -1151,6 +1240,19 @@ database_api::get_account_history(const std::string& account, uint64_t from, uin
     return my->_db.with_read_lock([&]() {
         FC_ASSERT(limit <= 10000, "Limit of ${l} is greater than maxmimum allowed", ("l", limit));
         FC_ASSERT(from >= limit, "From must be greater than limit");
+
+        std::map<uint32_t, applied_operation> result;
+
+        auto store = my->_db.get_history_store();
+        if (store)
+        {
+            for (const auto& item : store->get_account_history(account, from, limit))
+            {
+                result[item.first] = item.second;
+            }
+            return result;
+        }
+
         //   idump((account)(from)(limit));
         const auto& idx = my->_db.get_index<account_history_index>().indices().get<by_account>();
         auto itr = idx.lower_bound(boost::make_tuple(account, from));
@@ -1158,7 +1260,6 @@ database_api::get_account_history(const std::string& account, uint64_t from, uin
         auto end = idx.upper_bound(boost::make_tuple(account, std::max(int64_t(0), int64_t(itr->sequence) - limit)));
         //   if( end != idx.end() ) idump((*end));
 
-        std::map<uint32_t, applied_operation> result;
         while (itr != end)
         {
             result[itr->sequence] = my->_db.get(itr->op);
@@ -2248,12 +2349,29 @@ annotated_signed_transaction database_api::get_transaction(transaction_id_type i
     FC_ASSERT(false, "This node's operator has disabled operation indexing by transaction_id");
 #else
     return my->_db.with_read_lock([&]() {
+        auto store = my->_db.get_history_store();
+        if (store)
+        {
+            fc::optional<indexed_operation> op = store->find_transaction(id);
+            FC_ASSERT(op.valid(), "Unknown Transaction ${t}", ("t", id));
+
+            // only the transaction is copied from the shared block
+            auto blk = my->_db.fetch_shared_block_by_number(op->block);
+            FC_ASSERT(blk);
+            FC_ASSERT(blk->transactions.size() > op->trx_in_block);
+            annotated_signed_transaction result = blk->transactions[op->trx_in_block];
+            result.block_num = op->block;
+            result.transaction_num = op->trx_in_block;
+            return result;
+        }
+
         const auto& idx = my->_db.get_index<operation_index>().indices().get<by_transaction_id>();
         auto itr = idx.lower_bound(id);
         if (itr != idx.end() && itr->trx_id == id)
         {
-            auto blk = my->_db.fetch_block_by_number(itr->block);
-            FC_ASSERT(blk.valid());
+            // only the transaction is copied from the shared block
+            auto blk = my->_db.fetch_shared_block_by_number(itr->block);
+            FC_ASSERT(blk);
             FC_ASSERT(blk->transactions.size() > itr->trx_in_block);
             annotated_signed_transaction result = blk->transactions[itr->trx_in_block];
             result.block_num = itr->block;
@@ -2,6 +2,7 @@
 
 #include <scorum/protocol/operations.hpp>
 #include <scorum/chain/schema/scorum_object_types.hpp>
+#include <scorum/chain/async_indexer.hpp>
 
 namespace scorum {
 namespace app {
@@ -10,6 +11,7 @@ struct applied_operation
 {
     applied_operation();
     applied_operation(const scorum::chain::operation_object& op_obj);
+    applied_operation(const scorum::chain::indexed_operation& indexed_op);
 
     scorum::protocol::transaction_id_type trx_id;
     uint32_t block = 0;
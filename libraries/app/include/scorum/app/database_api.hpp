@@ -119,6 +119,16 @@ public:
      */
     optional<block_header> get_block_header(uint32_t block_num) const;
 
+    /**
+     * @brief Retrieve headers of blocks produced in a time range
+     * @param start Lower bound of block timestamps, inclusive
+     * @param end Upper bound of block timestamps, exclusive
+     * @param limit Maximum number of results to return, must not exceed 1000
+     * @return header summaries of the blocks ordered by block number
+     */
+    std::vector<block_header_record>
+    get_block_headers_by_time(time_point_sec start, time_point_sec end, uint32_t limit) const;
+
     /**
      * @brief Retrieve a full, signed block
      * @param block_num Height of the block to be returned
@@ -134,6 +144,26 @@ public:
      */
     std::vector<applied_operation> get_ops_in_block(uint32_t block_num, bool only_virtual = true) const;
 
+    /**
+     * @brief Retrieve hit/miss counters of the in-memory cache of recent blocks
+     */
+    block_cache_stats get_block_cache_stats() const;
+
+    /**
+     * @brief Retrieve size of the pending transactions pool and counters of their re-application after blocks
+     */
+    mempool_stats get_mempool_stats() const;
+
+    /**
+     * @brief Retrieve time spent in phases of block application over recently applied blocks
+     */
+    block_timing_stats get_block_timing_stats() const;
+
+    /**
+     * @brief Retrieve the last block processed by plugins which index blocks asynchronously
+     */
+    async_indexer_stats get_async_indexer_stats() const;
+
     /////////////
     // Globals //
     /////////////
@@ -457,8 +487,13 @@ FC_API(scorum::app::database_api,
 
    // Blocks and transactions
    (get_block_header)
+   (get_block_headers_by_time)
    (get_block)
    (get_ops_in_block)
+   (get_block_cache_stats)
+   (get_mempool_stats)
+   (get_block_timing_stats)
+   (get_async_indexer_stats)
    (get_state)
 
    // Globals
@@ -484,15 +484,15 @@ struct dynamic_global_property_api_obj : public dynamic_global_property_object
 
 struct budget_api_obj
 {
-    budget_api_obj(const chain::budget_object& b)
+    budget_api_obj(const chain::budget_object& b, uint32_t head_block_num)
         : id(b.id._id)
         , owner(b.owner)
         , content_permlink(fc::to_string(b.content_permlink))
         , created(b.created)
         , deadline(b.deadline)
-        , balance(b.balance)
+        , balance(b.balance_at(head_block_num))
         , per_block(b.per_block)
-        , last_allocated_block(b.last_allocated_block)
+        , last_allocated_block(std::max(b.last_allocated_block, head_block_num))
     {
     }
 
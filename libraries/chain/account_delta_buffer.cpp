@@ -0,0 +1,120 @@
+#include <scorum/chain/account_delta_buffer.hpp>
+#include <scorum/chain/database.hpp>
+
+#include <scorum/chain/services/account.hpp>
+
+#include <scorum/chain/schema/account_objects.hpp>
+#include <scorum/chain/schema/dynamic_global_property_object.hpp>
+
+namespace scorum {
+namespace chain {
+
+account_delta_buffer::account_delta_buffer(database& db)
+    : _db(db)
+{
+}
+
+void account_delta_buffer::increase_balance(const account_object& account, const asset& scorums)
+{
+    FC_ASSERT(scorums.symbol == SCORUM_SYMBOL, "invalid asset type (symbol)");
+    _deltas[account.id].balance += scorums.amount;
+}
+
+asset account_delta_buffer::create_vesting(const account_object& account, const asset& scorums)
+{
+    FC_ASSERT(scorums.symbol == SCORUM_SYMBOL, "invalid asset type (symbol)");
+
+    asset new_vesting = scorums * _db.get_dynamic_global_properties().get_vesting_share_price();
+
+    account_delta& delta = _deltas[account.id];
+    delta.vesting_shares += new_vesting.amount;
+    delta.created_vesting_shares += new_vesting.amount;
+    delta.vested = true;
+
+    return new_vesting;
+}
+
+void account_delta_buffer::increase_vesting_shares(const account_object& account, const asset& vesting)
+{
+    FC_ASSERT(vesting.symbol == VESTS_SYMBOL, "invalid asset type (symbol)");
+
+    account_delta& delta = _deltas[account.id];
+    delta.vesting_shares += vesting.amount;
+    delta.vested = true;
+}
+
+void account_delta_buffer::increase_curation_rewards(const account_object& account, const share_type& amount)
+{
+    _deltas[account.id].curation_rewards += amount;
+}
+
+void account_delta_buffer::increase_posting_rewards(const account_object& account, const share_type& amount)
+{
+    _deltas[account.id].posting_rewards += amount;
+}
+
+void account_delta_buffer::flush()
+{
+    if (_deltas.empty())
+        return;
+
+    share_type total_balance = 0;
+    share_type total_created_vesting_shares = 0;
+    for (const auto& d : _deltas)
+    {
+        total_balance += d.second.balance;
+        total_created_vesting_shares += d.second.created_vesting_shares;
+    }
+
+    _apply_totals(total_balance, total_created_vesting_shares);
+
+    for (const auto& d : _deltas)
+    {
+        _apply(_db.get(d.first), d.second);
+    }
+
+    _deltas.clear();
+}
+
+void account_delta_buffer::flush(const account_object& account)
+{
+    auto it = _deltas.find(account.id);
+    if (it == _deltas.end())
+        return;
+
+    const account_delta delta = it->second;
+    _deltas.erase(it);
+
+    _apply_totals(delta.balance, delta.created_vesting_shares);
+    _apply(account, delta);
+}
+
+void account_delta_buffer::_apply_totals(const share_type& balance, const share_type& created_vesting_shares)
+{
+    // totals go first, witness votes are checked against total vesting shares
+    _db.modify(_db.get_dynamic_global_properties(), [&](dynamic_global_property_object& props) {
+        props.total_accounts_balance.amount += balance;
+        props.total_vesting_shares.amount += created_vesting_shares;
+    });
+}
+
+void account_delta_buffer::_apply(const account_object& account, const account_delta& delta)
+{
+    _db.modify(account, [&](account_object& a) {
+        a.balance.amount += delta.balance;
+        a.vesting_shares.amount += delta.vesting_shares;
+#ifndef IS_LOW_MEM
+        a.curation_rewards += delta.curation_rewards;
+        a.posting_rewards += delta.posting_rewards;
+#endif
+    });
+
+    // witness vote is adjusted even for zero vesting, that updates its virtual schedule position
+    if (delta.vested)
+    {
+        _db.obtain_service<dbs_account>().adjust_proxied_witness_votes(account, delta.vesting_shares);
+    }
+}
+
+} // namespace chain
+} // namespace scorum
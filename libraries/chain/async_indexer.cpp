@@ -0,0 +1,213 @@
+#include <scorum/chain/async_indexer.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger.hpp>
+
+#include <algorithm>
+
+namespace scorum {
+namespace chain {
+
+async_indexer::async_indexer(uint32_t max_pending_blocks)
+    : _max_pending_blocks(std::max<uint32_t>(max_pending_blocks, 1))
+{
+}
+
+async_indexer::~async_indexer()
+{
+    stop();
+}
+
+void async_indexer::add_consumer(const std::string& name, block_handler on_block, rollback_handler on_rollback)
+{
+    FC_ASSERT(!_thread.joinable(), "Consumers must be added before blocks are applied");
+
+    consumer c;
+    c.name = name;
+    c.on_block = on_block;
+    c.on_rollback = on_rollback;
+    _consumers.push_back(c);
+}
+
+void async_indexer::begin_block(uint32_t block_num, const block_id_type& block_id, fc::time_point_sec timestamp)
+{
+    if (!has_consumers())
+        return;
+
+    _current = indexed_block();
+    _current.block_num = block_num;
+    _current.block_id = block_id;
+    _current.timestamp = timestamp;
+    _collecting = true;
+}
+
+void async_indexer::add_operation(const operation_notification& note, fc::time_point_sec timestamp)
+{
+    if (!_collecting)
+        return;
+
+    indexed_operation op;
+    op.trx_id = note.trx_id;
+    op.block = note.block;
+    op.trx_in_block = note.trx_in_block;
+    op.op_in_trx = note.op_in_trx;
+    op.virtual_op = note.virtual_op;
+    op.timestamp = timestamp;
+    op.op = note.op;
+
+    _current.operations.push_back(std::move(op));
+}
+
+void async_indexer::end_block(uint32_t last_irreversible_block_num)
+{
+    if (!_collecting)
+        return;
+
+    _collecting = false;
+
+    task t;
+    t.block_num = _current.block_num;
+    t.block = std::move(_current);
+    t.block.last_irreversible_block_num = last_irreversible_block_num;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _head_block_num = t.block_num;
+    push(std::move(t), lock);
+}
+
+void async_indexer::abort_block()
+{
+    _collecting = false;
+    _current = indexed_block();
+}
+
+void async_indexer::pop_block(uint32_t head_block_num)
+{
+    if (!has_consumers())
+        return;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _head_block_num = head_block_num;
+
+    while (!_queue.empty() && !_queue.back().rollback && _queue.back().block_num > head_block_num)
+    {
+        _queue.pop_back();
+    }
+
+    // consumers could have seen the popped block unless it is followed by one they are going to process
+    if (_queue.empty() || _queue.back().rollback)
+    {
+        task t;
+        t.rollback = true;
+        t.block_num = head_block_num;
+        push(std::move(t), lock);
+    }
+}
+
+void async_indexer::push(task&& t, std::unique_lock<std::mutex>& lock)
+{
+    _done_cv.wait(lock, [&]() { return _queue.size() < _max_pending_blocks; });
+
+    _queue.push_back(std::move(t));
+
+    if (!_thread.joinable())
+    {
+        _stopping = false;
+        _thread = std::thread(&async_indexer::run, this);
+    }
+
+    _queue_cv.notify_one();
+}
+
+void async_indexer::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done_cv.wait(lock, [&]() { return _queue.empty() && !_processing; });
+}
+
+void async_indexer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_thread.joinable())
+            return;
+        _stopping = true;
+    }
+
+    _queue_cv.notify_all();
+    _thread.join();
+}
+
+async_indexer_stats async_indexer::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    async_indexer_stats stats;
+    stats.head_block_num = _head_block_num;
+    stats.indexed_block_num = get_indexed_block_num();
+    stats.pending_blocks = (uint32_t)_queue.size();
+    stats.indexed_blocks = _indexed_blocks;
+    stats.rollbacks = _rollbacks;
+    return stats;
+}
+
+void async_indexer::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for (;;)
+    {
+        _queue_cv.wait(lock, [&]() { return _stopping || !_queue.empty(); });
+
+        // queued blocks are processed before stopping
+        if (_queue.empty())
+            break;
+
+        task t = std::move(_queue.front());
+        _queue.pop_front();
+        _processing = true;
+        _done_cv.notify_all();
+
+        lock.unlock();
+        process(t);
+        lock.lock();
+
+        _processing = false;
+        if (t.rollback)
+            ++_rollbacks;
+        else
+            ++_indexed_blocks;
+        _done_cv.notify_all();
+    }
+}
+
+void async_indexer::process(const task& t)
+{
+    for (const consumer& c : _consumers)
+    {
+        try
+        {
+            if (t.rollback)
+                c.on_rollback(t.block_num);
+            else
+                c.on_block(t.block);
+        }
+        catch (const fc::exception& e)
+        {
+            elog("Consumer ${c} failed to process block ${b}: ${e}",
+                 ("c", c.name)("b", t.block_num)("e", e.to_detail_string()));
+        }
+        catch (const std::exception& e)
+        {
+            elog("Consumer ${c} failed to process block ${b}: ${e}", ("c", c.name)("b", t.block_num)("e", e.what()));
+        }
+    }
+
+    if (t.rollback)
+        _indexed_block_num.store(std::min(get_indexed_block_num(), t.block_num), std::memory_order_release);
+    else
+        _indexed_block_num.store(t.block_num, std::memory_order_release);
+}
+
+} // namespace chain
+} // namespace scorum
@@ -0,0 +1,51 @@
+#include <scorum/chain/authority_cache.hpp>
+
+namespace scorum {
+namespace chain {
+
+authority_cache::authority_ptr
+authority_cache::get(const account_name_type& name, authority_type type, const loader_type& load)
+{
+    auto key = std::make_pair(name, type);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _authorities.find(key);
+        if (it != _authorities.end())
+            return it->second;
+    }
+
+    // loaded without the lock, concurrent loads of the same authority give the same result
+    authority_ptr result = std::make_shared<const authority>(load());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _authorities.emplace(key, result).first->second;
+}
+
+void authority_cache::invalidate(const account_name_type& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _authorities.lower_bound(std::make_pair(name, active));
+    while (it != _authorities.end() && it->first.first == name)
+    {
+        it = _authorities.erase(it);
+    }
+}
+
+void authority_cache::enable()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _authorities.clear();
+    _enabled = true;
+}
+
+void authority_cache::disable()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _authorities.clear();
+    _enabled = false;
+}
+
+} // namespace chain
+} // namespace scorum
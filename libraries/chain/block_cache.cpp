@@ -0,0 +1,147 @@
+#include <scorum/chain/block_cache.hpp>
+
+namespace scorum {
+namespace chain {
+
+block_cache::block_cache(uint32_t capacity)
+    : _capacity(capacity)
+{
+}
+
+void block_cache::set_capacity(uint32_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    _shrink_to(_capacity);
+}
+
+void block_cache::insert(const signed_block& b)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_capacity == 0)
+        return;
+
+    item i;
+    i.num = b.block_num();
+    i.id = b.id();
+
+    if (_relocate(i.num, i.id))
+        return;
+
+    i.data = std::make_shared<const signed_block>(b);
+    _items.push_front(std::move(i));
+
+    _shrink_to(_capacity);
+}
+
+void block_cache::insert(const block_ptr& b)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_capacity == 0)
+        return;
+
+    item i;
+    i.num = b->block_num();
+    i.id = b->id();
+
+    if (_relocate(i.num, i.id))
+        return;
+
+    i.data = b;
+    _items.push_front(std::move(i));
+
+    _shrink_to(_capacity);
+}
+
+bool block_cache::_relocate(uint32_t num, const block_id_type& id)
+{
+    // a block at the same height can only be the one we replace after a fork switch
+    auto& num_idx = _items.get<by_num>();
+    auto it = num_idx.find(num);
+    if (it != num_idx.end())
+    {
+        if (it->id == id)
+        {
+            _items.relocate(_items.begin(), _items.project<0>(it));
+            return true;
+        }
+        num_idx.erase(it);
+    }
+
+    return false;
+}
+
+template <typename Iterator> block_cache::block_ptr block_cache::_touch(Iterator it) const
+{
+    _items.relocate(_items.begin(), _items.project<0>(it));
+    ++_hits;
+    return it->data;
+}
+
+block_cache::block_ptr block_cache::fetch_by_number(uint32_t block_num) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto& idx = _items.get<by_num>();
+    auto it = idx.find(block_num);
+    if (it == idx.end())
+    {
+        ++_misses;
+        return block_ptr();
+    }
+
+    return _touch(it);
+}
+
+block_cache::block_ptr block_cache::fetch_by_id(const block_id_type& id) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto& idx = _items.get<by_id>();
+    auto it = idx.find(id);
+    if (it == idx.end())
+    {
+        ++_misses;
+        return block_ptr();
+    }
+
+    return _touch(it);
+}
+
+void block_cache::remove(const block_id_type& id)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _items.get<by_id>().erase(id);
+}
+
+void block_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _items.clear();
+}
+
+block_cache_stats block_cache::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    block_cache_stats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.size = (uint32_t)_items.size();
+    stats.capacity = _capacity;
+
+    return stats;
+}
+
+void block_cache::_shrink_to(uint32_t size)
+{
+    while (_items.size() > size)
+    {
+        _items.pop_back();
+    }
+}
+
+} // namespace chain
+} // namespace scorum
@@ -1,5 +1,16 @@
 #include <scorum/chain/block_log.hpp>
+#include <scorum/chain/util/parallel.hpp>
+#include <scorum/protocol/config.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <fc/io/json.hpp>
 #include <fc/io/raw.hpp>
 
 #define LOG_READ (std::ios::in | std::ios::binary)
@@ -9,17 +20,138 @@ namespace scorum {
 namespace chain {
 
 namespace detail {
-class block_log_impl
+
+// header record layout: id, previous, transaction_merkle_root, timestamp, transaction_count, flags, witness
+const size_t header_hash_size = sizeof(block_id_type);
+const size_t header_witness_offset = 3 * header_hash_size + 3 * sizeof(uint32_t);
+const size_t header_witness_size = block_log::header_record_size - header_witness_offset;
+const uint32_t header_has_extensions_flag = 1;
+
+static_assert(header_witness_size == SCORUM_MAX_ACCOUNT_NAME_LENGTH, "invalid block header record layout");
+
+void pack_header_record(const block_header_record& r, char* buf)
+{
+    FC_ASSERT(r.witness.size() <= header_witness_size, "Witness name does not fit header record.",
+              ("witness", r.witness));
+
+    std::memset(buf, 0, block_log::header_record_size);
+
+    char* p = buf;
+    std::memcpy(p, r.id.data(), header_hash_size);
+    p += header_hash_size;
+    std::memcpy(p, r.previous.data(), header_hash_size);
+    p += header_hash_size;
+    std::memcpy(p, r.transaction_merkle_root.data(), header_hash_size);
+    p += header_hash_size;
+
+    uint32_t sec = r.timestamp.sec_since_epoch();
+    uint32_t flags = r.has_extensions ? header_has_extensions_flag : 0;
+    std::memcpy(p, &sec, sizeof(sec));
+    p += sizeof(sec);
+    std::memcpy(p, &r.transaction_count, sizeof(r.transaction_count));
+    p += sizeof(r.transaction_count);
+    std::memcpy(p, &flags, sizeof(flags));
+    p += sizeof(flags);
+
+    std::memcpy(p, r.witness.data(), r.witness.size());
+}
+
+block_header_record unpack_header_record(const char* buf)
+{
+    block_header_record r;
+
+    const char* p = buf;
+    std::memcpy(r.id.data(), p, header_hash_size);
+    p += header_hash_size;
+    std::memcpy(r.previous.data(), p, header_hash_size);
+    p += header_hash_size;
+    std::memcpy(r.transaction_merkle_root.data(), p, header_hash_size);
+    p += header_hash_size;
+
+    uint32_t sec;
+    uint32_t flags;
+    std::memcpy(&sec, p, sizeof(sec));
+    p += sizeof(sec);
+    std::memcpy(&r.transaction_count, p, sizeof(r.transaction_count));
+    p += sizeof(r.transaction_count);
+    std::memcpy(&flags, p, sizeof(flags));
+    p += sizeof(flags);
+
+    r.timestamp = fc::time_point_sec(sec);
+    r.has_extensions = (flags & header_has_extensions_flag) != 0;
+    r.witness.assign(p, strnlen(p, header_witness_size));
+
+    return r;
+}
+
+fc::path index_file_of(const fc::path& block_file)
+{
+    return fc::path(block_file.generic_string() + ".index");
+}
+
+fc::path headers_file_of(const fc::path& block_file)
+{
+    return fc::path(block_file.generic_string() + ".headers");
+}
+
+fc::path manifest_file_of(const fc::path& block_file)
+{
+    return fc::path(block_file.generic_string() + ".manifest");
+}
+
+void remove_segment_files(const fc::path& block_file)
+{
+    fc::remove_all(block_file);
+    fc::remove_all(index_file_of(block_file));
+    fc::remove_all(headers_file_of(block_file));
+}
+
+// number of blocks decoded by one task of parallel index reconstruction and verification
+const uint32_t blocks_per_task = 10000;
+
+/**
+ * Continuous range of blocks stored in one file with own position and header indexes.
+ */
+class block_log_segment
 {
 public:
+    block_log_segment(const fc::path& file, uint32_t first_num)
+        : first_block_num(first_num)
+        , block_file(file)
+        , index_file(index_file_of(file))
+        , headers_file(headers_file_of(file))
+    {
+        block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+        index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+        headers_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+    }
+
+    const uint32_t first_block_num;
+
     optional<signed_block> head;
     block_id_type head_id;
     std::fstream block_stream;
     std::fstream index_stream;
+    std::fstream headers_stream;
     fc::path block_file;
     fc::path index_file;
-    bool block_write;
-    bool index_write;
+    fc::path headers_file;
+    bool block_write = false;
+    bool index_write = false;
+    bool headers_write = false;
+
+    /**
+     * Number of the last block in segment, first_block_num - 1 if segment is empty.
+     */
+    uint32_t head_num() const
+    {
+        return head.valid() ? protocol::block_header::num_from_id(head_id) : first_block_num - 1;
+    }
+
+    bool contains(uint32_t block_num) const
+    {
+        return head.valid() && block_num >= first_block_num && block_num <= head_num();
+    }
 
     inline void check_block_read()
     {
@@ -76,14 +208,490 @@ public:
         }
         FC_LOG_AND_RETHROW()
     }
+
+    inline void check_headers_read()
+    {
+        try
+        {
+            if (headers_write)
+            {
+                headers_stream.close();
+                headers_stream.open(headers_file.generic_string().c_str(), LOG_READ);
+                headers_write = false;
+            }
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    inline void check_headers_write()
+    {
+        try
+        {
+            if (!headers_write)
+            {
+                headers_stream.close();
+                headers_stream.open(headers_file.generic_string().c_str(), LOG_WRITE);
+                headers_write = true;
+            }
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    /**
+     * Open files of the segment, threads is the number of threads its header index can be rebuilt with
+     * (zero means all cores).
+     */
+    void open(uint32_t threads = 0)
+    {
+        block_stream.open(block_file.generic_string().c_str(), LOG_WRITE);
+        index_stream.open(index_file.generic_string().c_str(), LOG_WRITE);
+        headers_stream.open(headers_file.generic_string().c_str(), LOG_WRITE);
+        block_write = true;
+        index_write = true;
+        headers_write = true;
+
+        /* On startup of the block log, there are several states the log file and the index file can be
+         * in relation to eachother.
+         *
+         *                          Block Log
+         *                     Exists       Is New
+         *                 +------------+------------+
+         *          Exists |    Check   |   Delete   |
+         *   Index         |    Head    |    Index   |
+         *    File         +------------+------------+
+         *          Is New |   Replay   |     Do     |
+         *                 |    Log     |   Nothing  |
+         *                 +------------+------------+
+         *
+         * Checking the heads of the files has several conditions as well.
+         *  - If they are the same, do nothing.
+         *  - If the index file head is not in the log file, delete the index and replay.
+         *  - If the index file head is in the log, but not up to date, replay from index head.
+         */
+        auto log_size = fc::file_size(block_file);
+        auto index_size = fc::file_size(index_file);
+        auto headers_size = fc::file_size(headers_file);
+
+        if (log_size)
+        {
+            ilog("Log ${f} is nonempty", ("f", block_file.filename().generic_string()));
+            head = read_head();
+            head_id = head->id();
+            FC_ASSERT(head->block_num() >= first_block_num, "Block log segment head is below its first block.",
+                      ("head", head->block_num())("first", first_block_num));
+
+            if (index_size)
+            {
+                check_block_read();
+                check_index_read();
+
+                ilog("Index is nonempty");
+                uint64_t block_pos;
+                block_stream.seekg(-sizeof(uint64_t), std::ios::end);
+                block_stream.read((char*)&block_pos, sizeof(block_pos));
+
+                uint64_t index_pos;
+                index_stream.seekg(-sizeof(uint64_t), std::ios::end);
+                index_stream.read((char*)&index_pos, sizeof(index_pos));
+
+                if (block_pos < index_pos)
+                {
+                    ilog("block_pos < index_pos, close and reopen index_stream");
+                    construct_index();
+                }
+                else if (block_pos > index_pos)
+                {
+                    ilog("Index is incomplete");
+                    construct_index();
+                }
+            }
+            else
+            {
+                ilog("Index is empty");
+                construct_index();
+            }
+
+            uint64_t expected_headers_size = uint64_t(block_log::header_record_size) * (head_num() + 1 - first_block_num);
+            if (headers_size < expected_headers_size && headers_size % block_log::header_record_size == 0)
+            {
+                ilog("Header index is incomplete");
+                construct_header_index(first_block_num + uint32_t(headers_size / block_log::header_record_size),
+                                       threads);
+            }
+            else if (headers_size != expected_headers_size)
+            {
+                ilog("Header index does not match log, recreate it");
+                construct_header_index(first_block_num, threads);
+            }
+        }
+        else
+        {
+            if (index_size)
+            {
+                ilog("Index is nonempty, remove and recreate it");
+                index_stream.close();
+                fc::remove_all(index_file);
+                index_stream.open(index_file.generic_string().c_str(), LOG_WRITE);
+                index_write = true;
+            }
+
+            if (headers_size)
+            {
+                ilog("Header index is nonempty, remove and recreate it");
+                headers_stream.close();
+                fc::remove_all(headers_file);
+                headers_stream.open(headers_file.generic_string().c_str(), LOG_WRITE);
+                headers_write = true;
+            }
+        }
+    }
+
+    uint64_t append(const signed_block& b)
+    {
+        check_block_write();
+        check_index_write();
+        check_headers_write();
+
+        uint64_t offset = (uint64_t)b.block_num() - first_block_num;
+
+        uint64_t pos = block_stream.tellp();
+        FC_ASSERT((uint64_t)index_stream.tellp() == sizeof(uint64_t) * offset,
+                  "Append to index file occuring at wrong position.",
+                  ("position", (uint64_t)index_stream.tellp())("expected", offset * sizeof(uint64_t)));
+        FC_ASSERT((uint64_t)headers_stream.tellp() == (uint64_t)block_log::header_record_size * offset,
+                  "Append to header index file occuring at wrong position.",
+                  ("position", (uint64_t)headers_stream.tellp())("expected", offset * block_log::header_record_size));
+        auto data = fc::raw::pack(b);
+        char record[block_log::header_record_size];
+        pack_header_record(block_header_record(b), record);
+        block_stream.write(data.data(), data.size());
+        block_stream.write((char*)&pos, sizeof(pos));
+        index_stream.write((char*)&pos, sizeof(pos));
+        headers_stream.write(record, sizeof(record));
+        head = b;
+        head_id = b.id();
+
+        return pos;
+    }
+
+    void flush()
+    {
+        block_stream.flush();
+        index_stream.flush();
+        headers_stream.flush();
+    }
+
+    void close()
+    {
+        block_stream.close();
+        index_stream.close();
+        headers_stream.close();
+    }
+
+    std::pair<signed_block, uint64_t> read_block(uint64_t pos)
+    {
+        check_block_read();
+
+        block_stream.seekg(pos);
+        std::pair<signed_block, uint64_t> result;
+        fc::raw::unpack(block_stream, result.first);
+        result.second = uint64_t(block_stream.tellg()) + 8;
+        return result;
+    }
+
+    uint64_t get_block_pos(uint32_t block_num)
+    {
+        if (!contains(block_num))
+            return block_log::npos;
+
+        check_index_read();
+
+        index_stream.seekg(sizeof(uint64_t) * (block_num - first_block_num));
+        uint64_t pos;
+        index_stream.read((char*)&pos, sizeof(pos));
+        return pos;
+    }
+
+    optional<block_header_record> read_header_record(uint32_t block_num)
+    {
+        optional<block_header_record> r;
+
+        if (!contains(block_num))
+            return r;
+
+        check_headers_read();
+
+        char record[block_log::header_record_size];
+        headers_stream.seekg((uint64_t)block_log::header_record_size * (block_num - first_block_num));
+        headers_stream.read(record, sizeof(record));
+
+        r = unpack_header_record(record);
+        return r;
+    }
+
+    signed_block read_head()
+    {
+        check_block_read();
+
+        uint64_t pos;
+        block_stream.seekg(-sizeof(pos), std::ios::end);
+        block_stream.read((char*)&pos, sizeof(pos));
+        return read_block(pos).first;
+    }
+
+    /**
+     * Rebuild the position index by following the back pointers from the end of the file,
+     * only 8 bytes are read per block and nothing is deserialized.
+     */
+    void construct_index()
+    {
+        ilog("Reconstructing Block Log Index of ${f}...", ("f", block_file.filename().generic_string()));
+
+        std::fstream out;
+        out.exceptions(std::fstream::failbit | std::fstream::badbit);
+        index_stream.close();
+        fc::remove_all(index_file);
+        out.open(index_file.generic_string().c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+
+        check_block_read();
+
+        uint64_t count = head_num() + 1 - first_block_num;
+        std::vector<uint64_t> chunk(std::min<uint64_t>(count, blocks_per_task));
+
+        uint64_t pos;
+        block_stream.seekg(-sizeof(uint64_t), std::ios::end);
+        block_stream.read((char*)&pos, sizeof(pos));
+
+        // positions are collected from the last block backwards and written chunk by chunk
+        uint64_t chunk_end = count;
+        while (chunk_end > 0)
+        {
+            uint64_t chunk_begin = chunk_end > chunk.size() ? chunk_end - chunk.size() : 0;
+            for (uint64_t i = chunk_end; i-- > chunk_begin;)
+            {
+                chunk[i - chunk_begin] = pos;
+
+                if (i == 0)
+                {
+                    FC_ASSERT(pos == 0, "First block of block log does not start at the beginning of the file.",
+                              ("file", block_file)("pos", pos));
+                    break;
+                }
+
+                FC_ASSERT(pos >= sizeof(uint64_t), "Broken back pointer in block log.", ("file", block_file)("pos", pos));
+                uint64_t prev_pos;
+                block_stream.seekg(pos - sizeof(uint64_t));
+                block_stream.read((char*)&prev_pos, sizeof(prev_pos));
+                FC_ASSERT(prev_pos < pos, "Broken back pointer in block log.",
+                          ("file", block_file)("pos", pos)("prev_pos", prev_pos));
+                pos = prev_pos;
+            }
+
+            out.seekp(chunk_begin * sizeof(uint64_t));
+            out.write((const char*)chunk.data(), (chunk_end - chunk_begin) * sizeof(uint64_t));
+            chunk_end = chunk_begin;
+        }
+
+        out.close();
+        index_stream.open(index_file.generic_string().c_str(), LOG_WRITE);
+        index_write = true;
+    }
+
+    void construct_header_index(uint32_t from_block_num, uint32_t threads);
+};
+
+/**
+ * Read only view of a segment with own streams, so it can be used from worker threads.
+ */
+class block_log_segment_reader
+{
+public:
+    explicit block_log_segment_reader(const block_log_segment& segment)
+        : _first_block_num(segment.first_block_num)
+    {
+        _block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+        _index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+        _headers_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+        _block_stream.open(segment.block_file.generic_string().c_str(), LOG_READ);
+        _index_stream.open(segment.index_file.generic_string().c_str(), LOG_READ);
+        _headers_stream.open(segment.headers_file.generic_string().c_str(), LOG_READ);
+    }
+
+    signed_block read_block(uint32_t block_num)
+    {
+        uint64_t pos;
+        _index_stream.seekg(sizeof(uint64_t) * (block_num - _first_block_num));
+        _index_stream.read((char*)&pos, sizeof(pos));
+
+        signed_block b;
+        _block_stream.seekg(pos);
+        fc::raw::unpack(_block_stream, b);
+        return b;
+    }
+
+    block_header_record read_header_record(uint32_t block_num)
+    {
+        char record[block_log::header_record_size];
+        _headers_stream.seekg((uint64_t)block_log::header_record_size * (block_num - _first_block_num));
+        _headers_stream.read(record, sizeof(record));
+        return unpack_header_record(record);
+    }
+
+private:
+    const uint32_t _first_block_num;
+    std::ifstream _block_stream;
+    std::ifstream _index_stream;
+    std::ifstream _headers_stream;
 };
+
+void block_log_segment::construct_header_index(uint32_t from_block_num, uint32_t threads)
+{
+    ilog("Reconstructing Block Log Header Index of ${f} from block ${n}...",
+         ("f", block_file.filename().generic_string())("n", from_block_num));
+
+    if (from_block_num <= first_block_num)
+    {
+        from_block_num = first_block_num;
+        headers_stream.close();
+        fc::remove_all(headers_file);
+        headers_stream.open(headers_file.generic_string().c_str(), LOG_WRITE);
+        headers_write = true;
+    }
+
+    if (from_block_num > head_num())
+        return;
+
+    // readers open own streams on the index, it must be on disk
+    index_stream.flush();
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    uint64_t blocks_per_round = (uint64_t)blocks_per_task * threads;
+    std::vector<std::vector<char>> buffers(threads);
+
+    // blocks are decoded in parallel by ranges, records are written in order after each round
+    for (uint64_t round_begin = from_block_num; round_begin <= head_num(); round_begin += blocks_per_round)
+    {
+        util::parallel_for(threads, threads, [&](size_t t) {
+            auto& buffer = buffers[t];
+            buffer.clear();
+
+            uint64_t begin = round_begin + t * blocks_per_task;
+            uint64_t end = std::min<uint64_t>(begin + blocks_per_task, (uint64_t)head_num() + 1);
+            if (begin >= end)
+                return;
+
+            block_log_segment_reader reader(*this);
+            buffer.resize((end - begin) * block_log::header_record_size);
+            for (uint64_t num = begin; num < end; ++num)
+            {
+                pack_header_record(block_header_record(reader.read_block((uint32_t)num)),
+                                   buffer.data() + (num - begin) * block_log::header_record_size);
+            }
+        });
+
+        check_headers_write();
+        for (const auto& buffer : buffers)
+        {
+            headers_stream.write(buffer.data(), buffer.size());
+        }
+    }
+}
+
+using block_log_segment_ptr = std::unique_ptr<block_log_segment>;
+
+class block_log_impl
+{
+public:
+    optional<signed_block> head;
+    fc::path file;
+    fc::path manifest_file;
+    block_log_manifest manifest;
+    std::vector<block_log_segment_ptr> segments;
+
+    fc::path segment_file(const block_log_segment_info& info) const
+    {
+        return file.parent_path() / info.file;
+    }
+
+    block_log_segment_info make_segment_info(uint32_t first_block_num) const
+    {
+        block_log_segment_info info;
+        info.first_block_num = first_block_num;
+        info.file = file.filename().generic_string();
+
+        // the segment starting from the first block keeps the name of the unsegmented log
+        if (first_block_num > 1)
+        {
+            std::stringstream ss;
+            ss << info.file << '.' << std::setw(10) << std::setfill('0') << first_block_num;
+            info.file = ss.str();
+        }
+
+        return info;
+    }
+
+    block_log_segment* find_segment(uint32_t block_num) const
+    {
+        if (segments.empty() || block_num < segments.front()->first_block_num)
+            return nullptr;
+
+        auto it = std::upper_bound(
+            segments.begin(), segments.end(), block_num,
+            [](uint32_t num, const block_log_segment_ptr& segment) { return num < segment->first_block_num; });
+        --it;
+
+        return (*it)->contains(block_num) ? it->get() : nullptr;
+    }
+
+    void save_manifest() const
+    {
+        fc::json::save_to_file(manifest, manifest_file);
+    }
+
+    void open_segments()
+    {
+        // segments are independent files, so their indexes are checked and rebuilt in parallel,
+        // cores are split between segments and header index reconstruction of each segment
+        uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+        uint32_t segment_threads = (uint32_t)std::max<size_t>(1, std::min<size_t>(segments.size(), cores));
+        uint32_t header_threads = std::max(1u, cores / segment_threads);
+
+        util::parallel_for(segments.size(), segment_threads, [&](size_t i) { segments[i]->open(header_threads); });
+    }
+
+    block_log_segment* add_segment(uint32_t first_block_num)
+    {
+        auto info = make_segment_info(first_block_num);
+
+        ilog("Starting block log segment ${f}", ("f", info.file));
+
+        segments.emplace_back(new block_log_segment(segment_file(info), first_block_num));
+        segments.back()->open();
+
+        manifest.segments.push_back(info);
+        save_manifest();
+
+        return segments.back().get();
+    }
+};
+}
+
+block_header_record::block_header_record(const signed_block& b)
+    : id(b.id())
+    , previous(b.previous)
+    , timestamp(b.timestamp)
+    , witness(b.witness)
+    , transaction_merkle_root(b.transaction_merkle_root)
+    , transaction_count((uint32_t)b.transactions.size())
+    , has_extensions(!b.extensions.empty())
+{
 }
 
 block_log::block_log()
     : my(new detail::block_log_impl())
 {
-    my->block_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
-    my->index_stream.exceptions(std::fstream::failbit | std::fstream::badbit);
 }
 
 block_log::~block_log()
@@ -91,87 +699,57 @@ block_log::~block_log()
     flush();
 }
 
-void block_log::open(const fc::path& file)
+void block_log::open(const fc::path& file, uint32_t segment_blocks)
 {
-    if (my->block_stream.is_open())
-        my->block_stream.close();
-    if (my->index_stream.is_open())
-        my->index_stream.close();
-
-    my->block_file = file;
-    my->index_file = fc::path(file.generic_string() + ".index");
-
-    my->block_stream.open(my->block_file.generic_string().c_str(), LOG_WRITE);
-    my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
-    my->block_write = true;
-    my->index_write = true;
-
-    /* On startup of the block log, there are several states the log file and the index file can be
-     * in relation to eachother.
-     *
-     *                          Block Log
-     *                     Exists       Is New
-     *                 +------------+------------+
-     *          Exists |    Check   |   Delete   |
-     *   Index         |    Head    |    Index   |
-     *    File         +------------+------------+
-     *          Is New |   Replay   |     Do     |
-     *                 |    Log     |   Nothing  |
-     *                 +------------+------------+
-     *
-     * Checking the heads of the files has several conditions as well.
-     *  - If they are the same, do nothing.
-     *  - If the index file head is not in the log file, delete the index and replay.
-     *  - If the index file head is in the log, but not up to date, replay from index head.
-     */
-    auto log_size = fc::file_size(my->block_file);
-    auto index_size = fc::file_size(my->index_file);
-
-    if (log_size)
+    try
     {
-        ilog("Log is nonempty");
-        my->head = read_head();
-        my->head_id = my->head->id();
+        my.reset(new detail::block_log_impl());
 
-        if (index_size)
+        my->file = file;
+        my->manifest_file = detail::manifest_file_of(file);
+
+        bool has_manifest = fc::exists(my->manifest_file);
+        if (has_manifest)
         {
-            my->check_block_read();
-            my->check_index_read();
+            my->manifest = fc::json::from_file(my->manifest_file).as<block_log_manifest>();
+            FC_ASSERT(!my->manifest.segments.empty(), "Block log manifest has no segments.");
+        }
+        else
+        {
+            my->manifest.segments.push_back(my->make_segment_info(1));
+        }
+        my->manifest.segment_blocks = segment_blocks;
+
+        for (const auto& info : my->manifest.segments)
+        {
+            my->segments.emplace_back(new detail::block_log_segment(my->segment_file(info), info.first_block_num));
+        }
 
-            ilog("Index is nonempty");
-            uint64_t block_pos;
-            my->block_stream.seekg(-sizeof(uint64_t), std::ios::end);
-            my->block_stream.read((char*)&block_pos, sizeof(block_pos));
+        my->open_segments();
 
-            uint64_t index_pos;
-            my->index_stream.seekg(-sizeof(uint64_t), std::ios::end);
-            my->index_stream.read((char*)&index_pos, sizeof(index_pos));
+        for (size_t i = 1; i < my->segments.size(); ++i)
+        {
+            FC_ASSERT(my->segments[i - 1]->head_num() + 1 == my->segments[i]->first_block_num,
+                      "Block log segments are not continuous.",
+                      ("segment", my->segments[i]->block_file)("first", my->segments[i]->first_block_num)(
+                          "previous_head", my->segments[i - 1]->head_num()));
+        }
 
-            if (block_pos < index_pos)
+        for (auto it = my->segments.rbegin(); it != my->segments.rend(); ++it)
+        {
+            if ((*it)->head.valid())
             {
-                ilog("block_pos < index_pos, close and reopen index_stream");
-                construct_index();
-            }
-            else if (block_pos > index_pos)
-            {
-                ilog("Index is incomplete");
-                construct_index();
+                my->head = (*it)->head;
+                break;
             }
         }
-        else
+
+        if (has_manifest || segment_blocks != 0)
         {
-            ilog("Index is empty");
-            construct_index();
+            my->save_manifest();
         }
     }
-    else if (index_size)
-    {
-        ilog("Index is nonempty, remove and recreate it");
-        my->index_stream.close();
-        fc::remove_all(my->index_file);
-        my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
-        my->index_write = true;
-    }
+    FC_LOG_AND_RETHROW()
 }
 
 void block_log::close()
@@ -181,28 +759,27 @@ void block_log::close()
 
 bool block_log::is_open() const
 {
-    return my->block_stream.is_open();
+    return !my->segments.empty() && my->segments.back()->block_stream.is_open();
 }
 
 uint64_t block_log::append(const signed_block& b)
 {
     try
     {
-        my->check_block_write();
-        my->check_index_write();
+        FC_ASSERT(!my->segments.empty(), "Block log is not open.");
 
-        uint64_t pos = my->block_stream.tellp();
-        FC_ASSERT((uint64_t)my->index_stream.tellp()
-                      == (std::fstream::streampos)sizeof(uint64_t) * ((uint64_t)b.block_num() - 1),
-                  "Append to index file occuring at wrong position.",
-                  ("position", (uint64_t)my->index_stream.tellp())("expected",
-                                                                   ((uint64_t)b.block_num() - 1) * sizeof(uint64_t)));
-        auto data = fc::raw::pack(b);
-        my->block_stream.write(data.data(), data.size());
-        my->block_stream.write((char*)&pos, sizeof(pos));
-        my->index_stream.write((char*)&pos, sizeof(pos));
+        auto block_num = b.block_num();
+        detail::block_log_segment* segment = my->segments.back().get();
+
+        if (my->manifest.segment_blocks != 0 && segment->head.valid()
+            && block_num >= segment->first_block_num + my->manifest.segment_blocks)
+        {
+            segment->flush();
+            segment = my->add_segment(block_num);
+        }
+
+        auto pos = segment->append(b);
         my->head = b;
-        my->head_id = b.id();
 
         return pos;
     }
@@ -211,23 +788,10 @@ uint64_t block_log::append(const signed_block& b)
 
 void block_log::flush()
 {
-    my->block_stream.flush();
-    my->index_stream.flush();
-}
-
-std::pair<signed_block, uint64_t> block_log::read_block(uint64_t pos) const
-{
-    try
+    for (auto& segment : my->segments)
     {
-        my->check_block_read();
-
-        my->block_stream.seekg(pos);
-        std::pair<signed_block, uint64_t> result;
-        fc::raw::unpack(my->block_stream, result.first);
-        result.second = uint64_t(my->block_stream.tellg()) + 8;
-        return result;
+        segment->flush();
     }
-    FC_LOG_AND_RETHROW()
 }
 
 optional<signed_block> block_log::read_block_by_num(uint32_t block_num) const
@@ -235,10 +799,10 @@ optional<signed_block> block_log::read_block_by_num(uint32_t block_num) const
     try
     {
         optional<signed_block> b;
-        uint64_t pos = get_block_pos(block_num);
-        if (pos != npos)
+        detail::block_log_segment* segment = my->find_segment(block_num);
+        if (segment != nullptr)
         {
-            b = read_block(pos).first;
+            b = segment->read_block(segment->get_block_pos(block_num)).first;
             FC_ASSERT(b->block_num() == block_num, "Wrong block was read from block log.",
                       ("returned", b->block_num())("expected", block_num));
         }
@@ -251,14 +815,10 @@ uint64_t block_log::get_block_pos(uint32_t block_num) const
 {
     try
     {
-        my->check_index_read();
-
-        if (!(my->head.valid() && block_num <= protocol::block_header::num_from_id(my->head_id) && block_num > 0))
+        detail::block_log_segment* segment = my->find_segment(block_num);
+        if (segment == nullptr)
             return npos;
-        my->index_stream.seekg(sizeof(uint64_t) * (block_num - 1));
-        uint64_t pos;
-        my->index_stream.read((char*)&pos, sizeof(pos));
-        return pos;
+        return segment->get_block_pos(block_num);
     }
     FC_LOG_AND_RETHROW()
 }
@@ -267,12 +827,8 @@ signed_block block_log::read_head() const
 {
     try
     {
-        my->check_block_read();
-
-        uint64_t pos;
-        my->block_stream.seekg(-sizeof(pos), std::ios::end);
-        my->block_stream.read((char*)&pos, sizeof(pos));
-        return read_block(pos).first;
+        FC_ASSERT(my->head.valid(), "Block log is empty.");
+        return my->find_segment(my->head->block_num())->read_head();
     }
     FC_LOG_AND_RETHROW()
 }
@@ -282,32 +838,265 @@ const optional<signed_block>& block_log::head() const
     return my->head;
 }
 
-void block_log::construct_index()
+uint32_t block_log::first_block_num() const
+{
+    return my->segments.empty() ? 1 : my->segments.front()->first_block_num;
+}
+
+uint32_t block_log::prune(uint32_t up_to_block_num)
 {
     try
     {
-        ilog("Reconstructing Block Log Index...");
-        my->index_stream.close();
-        fc::remove_all(my->index_file);
-        my->index_stream.open(my->index_file.generic_string().c_str(), LOG_WRITE);
-        my->index_write = true;
+        std::vector<detail::block_log_segment_ptr> removed;
 
-        uint64_t pos = 0;
-        uint64_t end_pos;
-        my->check_block_read();
+        while (my->segments.size() > 1 && my->segments.front()->head_num() <= up_to_block_num)
+        {
+            removed.push_back(std::move(my->segments.front()));
+            my->segments.erase(my->segments.begin());
+            my->manifest.segments.erase(my->manifest.segments.begin());
+        }
 
-        my->block_stream.seekg(-sizeof(uint64_t), std::ios::end);
-        my->block_stream.read((char*)&end_pos, sizeof(end_pos));
-        signed_block tmp;
+        if (removed.empty())
+            return 0;
 
-        my->block_stream.seekg(pos);
+        // the manifest is updated first, so a crash can only leave unreferenced files behind
+        my->save_manifest();
 
-        while (pos < end_pos)
+        uint32_t removed_blocks = 0;
+        for (auto& segment : removed)
         {
-            fc::raw::unpack(my->block_stream, tmp);
-            my->block_stream.read((char*)&pos, sizeof(pos));
-            my->index_stream.write((char*)&pos, sizeof(pos));
+            removed_blocks += segment->head_num() + 1 - segment->first_block_num;
+            segment->close();
+            detail::remove_segment_files(segment->block_file);
         }
+
+        ilog("Pruned ${n} blocks from block log, first block is ${f}",
+             ("n", removed_blocks)("f", my->segments.front()->first_block_num));
+
+        return removed_blocks;
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+optional<block_header_record> block_log::read_header_record_by_num(uint32_t block_num) const
+{
+    try
+    {
+        optional<block_header_record> r;
+
+        detail::block_log_segment* segment = my->find_segment(block_num);
+        if (segment == nullptr)
+            return r;
+
+        r = segment->read_header_record(block_num);
+        FC_ASSERT(r->block_num() == block_num, "Wrong header was read from header index.",
+                  ("returned", r->block_num())("expected", block_num));
+        return r;
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+optional<block_header> block_log::read_header_by_num(uint32_t block_num) const
+{
+    try
+    {
+        optional<block_header> h;
+
+        auto r = read_header_record_by_num(block_num);
+        if (!r.valid())
+            return h;
+
+        if (r->has_extensions)
+        {
+            auto b = read_block_by_num(block_num);
+            if (b.valid())
+                h = block_header(*b);
+            return h;
+        }
+
+        h = block_header();
+        h->previous = r->previous;
+        h->timestamp = r->timestamp;
+        h->witness = r->witness;
+        h->transaction_merkle_root = r->transaction_merkle_root;
+        return h;
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+std::vector<block_header_record>
+block_log::read_header_records_by_time(fc::time_point_sec start, fc::time_point_sec end, uint32_t limit) const
+{
+    try
+    {
+        std::vector<block_header_record> result;
+
+        if (!my->head.valid() || limit == 0 || start >= end)
+            return result;
+
+        uint32_t head_num = my->head->block_num();
+
+        // find the first block with timestamp >= start
+        uint32_t lo = first_block_num();
+        uint32_t hi = head_num + 1;
+        while (lo < hi)
+        {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (read_header_record_by_num(mid)->timestamp < start)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        for (uint32_t num = lo; num <= head_num && result.size() < limit; ++num)
+        {
+            auto r = read_header_record_by_num(num);
+            if (r->timestamp >= end)
+                break;
+            result.push_back(*r);
+        }
+
+        return result;
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+block_log_verify_result block_log::verify(uint32_t threads) const
+{
+    try
+    {
+        block_log_verify_result result;
+
+        if (!my->head.valid())
+            return result;
+
+        result.first_block_num = first_block_num();
+        result.last_block_num = my->head->block_num();
+
+        struct range
+        {
+            const detail::block_log_segment* segment;
+            uint32_t begin;
+            uint32_t end;
+        };
+
+        std::vector<range> ranges;
+        for (auto& segment : my->segments)
+        {
+            // readers open own streams, everything must be on disk
+            segment->flush();
+
+            for (uint64_t begin = segment->first_block_num; begin <= segment->head_num();
+                 begin += detail::blocks_per_task)
+            {
+                uint64_t end = std::min<uint64_t>(begin + detail::blocks_per_task, (uint64_t)segment->head_num() + 1);
+                ranges.push_back({ segment.get(), (uint32_t)begin, (uint32_t)end });
+            }
+        }
+
+        std::vector<std::string> range_errors(ranges.size());
+        std::atomic<uint32_t> verified_blocks(0);
+        util::parallel_for(ranges.size(), threads, [&](size_t i) {
+            const range& r = ranges[i];
+
+            uint32_t verified = 0;
+            uint32_t num = r.begin;
+            std::string error;
+            try
+            {
+                detail::block_log_segment_reader reader(*r.segment);
+
+                for (; num < r.end; ++num)
+                {
+                    signed_block b = reader.read_block(num);
+                    block_id_type id = b.id();
+
+                    if (b.block_num() != num)
+                    {
+                        error = "wrong block number " + std::to_string(b.block_num());
+                    }
+                    else if (reader.read_header_record(num).id != id)
+                    {
+                        error = "id does not match header index";
+                    }
+                    else if (b.calculate_merkle_root() != b.transaction_merkle_root)
+                    {
+                        error = "transaction merkle root mismatch";
+                    }
+                    else if (num == 1 && b.previous != block_id_type())
+                    {
+                        error = "first block has previous block";
+                    }
+                    else if (num > r.segment->first_block_num && reader.read_header_record(num - 1).id != b.previous)
+                    {
+                        error = "previous does not match id of block " + std::to_string(num - 1);
+                    }
+
+                    if (!error.empty())
+                        break;
+
+                    ++verified;
+                }
+            }
+            // a corrupted position or record can not be decoded
+            catch (const fc::exception& e)
+            {
+                error = e.to_string();
+            }
+            catch (const std::exception& e)
+            {
+                error = e.what();
+            }
+
+            if (!error.empty())
+            {
+                error = "block " + std::to_string(num) + ": " + error;
+            }
+
+            verified_blocks += verified;
+            range_errors[i] = error;
+        });
+
+        result.verified_blocks = verified_blocks;
+        for (const auto& error : range_errors)
+        {
+            if (!error.empty())
+                result.errors.push_back(error);
+        }
+
+        // links between segments
+        for (size_t i = 1; i < my->segments.size(); ++i)
+        {
+            const auto& segment = *my->segments[i];
+            auto r = read_header_record_by_num(segment.first_block_num);
+            if (r.valid() && r->previous != my->segments[i - 1]->head_id)
+            {
+                result.errors.push_back("block " + std::to_string(segment.first_block_num)
+                                        + ": previous does not match head of previous segment");
+            }
+        }
+
+        return result;
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+void block_log::remove_files(const fc::path& file)
+{
+    try
+    {
+        fc::path manifest_file = detail::manifest_file_of(file);
+        if (fc::exists(manifest_file))
+        {
+            auto manifest = fc::json::from_file(manifest_file).as<block_log_manifest>();
+            for (const auto& info : manifest.segments)
+            {
+                detail::remove_segment_files(file.parent_path() / info.file);
+            }
+        }
+
+        detail::remove_segment_files(file);
+        fc::remove_all(manifest_file);
     }
     FC_LOG_AND_RETHROW()
 }
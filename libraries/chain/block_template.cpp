@@ -0,0 +1,65 @@
+#include <scorum/chain/block_template.hpp>
+#include <scorum/chain/database.hpp>
+
+namespace scorum {
+namespace chain {
+
+void block_template::reset(const block_id_type& head_id)
+{
+    _head_id = head_id;
+    _count = 0;
+    _total_size = 0;
+    _min_expiration = fc::time_point_sec::maximum();
+    _skip = 0;
+    _merkle_peaks.clear();
+}
+
+void block_template::push(const pending_transaction& ptx, uint32_t skip)
+{
+    ++_count;
+    _total_size += ptx.size;
+    _min_expiration = std::min(_min_expiration, ptx.expiration);
+
+    // size is checked by is_usable() against the limit at generation time
+    _skip |= skip & ~database::skip_block_size_check;
+
+    // merge equal subtrees the same way calculate_merkle_root() pairs hashes level by level
+    _merkle_peaks.push_back({ ptx.trx.merkle_digest(), 0 });
+    while (_merkle_peaks.size() > 1 && _merkle_peaks[_merkle_peaks.size() - 2].height == _merkle_peaks.back().height)
+    {
+        merkle_node right = _merkle_peaks.back();
+        _merkle_peaks.pop_back();
+
+        merkle_node& left = _merkle_peaks.back();
+        left.digest = digest_type::hash(std::make_pair(left.digest, right.digest));
+        ++left.height;
+    }
+}
+
+bool block_template::is_usable(const block_id_type& head_id,
+                               size_t pending_count,
+                               fc::time_point_sec when,
+                               uint64_t max_transactions_size,
+                               uint32_t skip) const
+{
+    return _head_id == head_id && _count == pending_count && _min_expiration >= when
+        && _total_size < max_transactions_size && (_skip & ~skip) == 0;
+}
+
+checksum_type block_template::merkle_root() const
+{
+    if (_merkle_peaks.empty())
+        return checksum_type();
+
+    // an unpaired subtree is carried up and hashed with the subtree on its left
+    digest_type root = _merkle_peaks.back().digest;
+    for (auto it = _merkle_peaks.rbegin() + 1; it != _merkle_peaks.rend(); ++it)
+    {
+        root = digest_type::hash(std::make_pair(it->digest, root));
+    }
+
+    return checksum_type::hash(root);
+}
+
+} // namespace chain
+} // namespace scorum
@@ -0,0 +1,144 @@
+#include <scorum/chain/block_timer.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace scorum {
+namespace chain {
+
+block_timer::block_timer(uint32_t window)
+    : _window(std::max<uint32_t>(window, 1))
+{
+}
+
+void block_timer::start_block()
+{
+    _current.fill(0);
+    _block_start = clock::now();
+    _phase_start = _block_start;
+}
+
+void block_timer::end_phase(phase_type phase)
+{
+    const auto now = clock::now();
+    _current[phase] += std::chrono::duration_cast<std::chrono::microseconds>(now - _phase_start).count();
+    _phase_start = now;
+}
+
+uint64_t block_timer::end_block(uint32_t block_num)
+{
+    const uint64_t total_us
+        = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - _block_start).count();
+    _current[phase_count] = total_us;
+
+    if (_history.size() < _window)
+    {
+        _history.push_back(_current);
+    }
+    else
+    {
+        _history[_next] = _current;
+    }
+    _next = (_next + 1) % _window;
+
+    _last_block_num = block_num;
+
+    if (is_slow(total_us))
+        ++_slow_blocks;
+
+    return total_us;
+}
+
+std::string block_timer::get_last_block_breakdown() const
+{
+    std::ostringstream out;
+    for (size_t phase = 0; phase < phase_count; ++phase)
+    {
+        if (phase != 0)
+            out << ", ";
+        out << get_phase_name((phase_type)phase) << ": " << _current[phase] << " us";
+    }
+    return out.str();
+}
+
+block_phase_stats block_timer::get_phase_stats(size_t phase, const char* name) const
+{
+    block_phase_stats stats;
+    stats.phase = name;
+
+    if (_history.empty())
+        return stats;
+
+    std::vector<uint64_t> times;
+    times.reserve(_history.size());
+
+    uint64_t sum = 0;
+    for (const block_times& t : _history)
+    {
+        times.push_back(t[phase]);
+        sum += t[phase];
+    }
+
+    std::sort(times.begin(), times.end());
+
+    auto percentile = [&](size_t percent) { return times[(times.size() * percent + 99) / 100 - 1]; };
+
+    stats.last_us = _history[(_next + _history.size() - 1) % _history.size()][phase];
+    stats.avg_us = sum / times.size();
+    stats.p50_us = percentile(50);
+    stats.p90_us = percentile(90);
+    stats.p99_us = percentile(99);
+    stats.max_us = times.back();
+
+    return stats;
+}
+
+block_timing_stats block_timer::get_stats() const
+{
+    block_timing_stats stats;
+    stats.last_block_num = _last_block_num;
+    stats.window = (uint32_t)_history.size();
+    stats.slow_blocks = _slow_blocks;
+    stats.total = get_phase_stats(phase_count, "total");
+
+    for (size_t phase = 0; phase < phase_count; ++phase)
+    {
+        stats.phases.push_back(get_phase_stats(phase, get_phase_name((phase_type)phase)));
+    }
+
+    return stats;
+}
+
+const char* block_timer::get_phase_name(phase_type phase)
+{
+    switch (phase)
+    {
+    case header:
+        return "header";
+    case transactions:
+        return "transactions";
+    case global_properties:
+        return "global_properties";
+    case irreversible_block:
+        return "irreversible_block";
+    case expirations:
+        return "expirations";
+    case witness_schedule:
+        return "witness_schedule";
+    case funds:
+        return "funds";
+    case comment_cashout:
+        return "comment_cashout";
+    case vesting_withdrawals:
+        return "vesting_withdrawals";
+    case hardforks:
+        return "hardforks";
+    case applied_block_handlers:
+        return "applied_block_handlers";
+    default:
+        return "unknown";
+    }
+}
+
+} // namespace chain
+} // namespace scorum
@@ -5,6 +5,7 @@
 #include <scorum/chain/database.hpp>
 #include <scorum/chain/database_exceptions.hpp>
 #include <scorum/chain/db_with.hpp>
+#include <scorum/chain/history_store.hpp>
 #include <scorum/chain/evaluators/evaluator_registry.hpp>
 #include <scorum/chain/schema/dynamic_global_property_object.hpp>
 #include <scorum/chain/schema/chain_property_object.hpp>
@@ -21,6 +22,7 @@
 #include <scorum/chain/genesis_state.hpp>
 
 #include <scorum/chain/util/asset.hpp>
+#include <scorum/chain/util/parallel.hpp>
 #include <scorum/chain/util/reward.hpp>
 #include <scorum/chain/util/uint256.hpp>
 
@@ -42,6 +44,9 @@
 #include <fc/io/fstream.hpp>
 #include <fc/io/json.hpp>
 
+#include <graphene/utilities/tracer.hpp>
+
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <fstream>
@@ -52,6 +57,8 @@
 #include <boost/core/ignore_unused.hpp>
 
 #include <scorum/chain/services/atomicswap.hpp>
+#include <scorum/chain/services/escrow.hpp>
+
 namespace scorum {
 namespace chain {
 
@@ -77,7 +84,9 @@ database::database()
     , dbservice_dbs_factory(*this)
     , data_service_factory(*this)
     , _my(new database_impl(*this))
+    , _account_deltas(*this)
 {
+    init_due_events();
 }
 
 database::~database()
@@ -108,7 +117,7 @@ void database::open(const fc::path& data_dir,
                 fc::create_directories(data_dir);
             }
 
-            _block_log.open(data_dir / "block_log");
+            _block_log.open(data_dir / "block_log", _block_log_segment_blocks);
 
             auto log_head = _block_log.head();
 
@@ -122,7 +131,7 @@ void database::open(const fc::path& data_dir,
                               ("rev", item.revision())("head_block", head_block_num()));
                 });
 
-                validate_invariants();
+                audit_invariants();
             });
 
             if (head_block_num())
@@ -157,31 +166,31 @@ void database::reindex(const fc::path& data_dir,
 
         auto start = fc::time_point::now();
         SCORUM_ASSERT(_block_log.head(), block_log_exception, "No blocks in block log. Cannot reindex an empty chain.");
+        SCORUM_ASSERT(_block_log.first_block_num() == 1, block_log_exception,
+                      "Block log is pruned, first block is ${n}. Cannot reindex without full history.",
+                      ("n", _block_log.first_block_num()));
 
         ilog("Replaying blocks...");
 
         uint64_t skip_flags = skip_witness_signature | skip_transaction_signatures | skip_transaction_dupe_check
             | skip_tapos_check | skip_merkle_check | skip_witness_schedule_check | skip_authority_check | skip_validate
             | /// no need to validate operations
-            skip_validate_invariants | skip_block_log;
+            skip_block_log;
 
         with_write_lock([&]() {
-            auto itr = _block_log.read_block(0);
             auto last_block_num = _block_log.head()->block_num();
 
-            while (itr.first.block_num() != last_block_num)
+            for (uint32_t cur_block_num = 1; cur_block_num <= last_block_num; ++cur_block_num)
             {
-                auto cur_block_num = itr.first.block_num();
                 if (cur_block_num % 100000 == 0)
                     std::cerr << "   " << double(cur_block_num * 100) / last_block_num << "%   " << cur_block_num
                               << " of " << last_block_num << "   (" << (get_free_memory() / (1024 * 1024))
                               << "M free)\n";
-                apply_block(itr.first, skip_flags);
-                itr = _block_log.read_block(itr.second);
+                auto block = _block_log.read_block_by_num(cur_block_num);
+                FC_ASSERT(block.valid(), "Block ${n} is missing in block log.", ("n", cur_block_num));
+                apply_block(*block, skip_flags);
             }
 
-            apply_block(itr.first, skip_flags);
-
             for_each_index([&](chainbase::abstract_generic_index_i& item) { item.set_revision(head_block_num()); });
         });
 
@@ -202,8 +211,7 @@ void database::wipe(const fc::path& data_dir, const fc::path& shared_mem_dir, bo
     chainbase::database::wipe();
     if (include_blocks)
     {
-        fc::remove_all(data_dir / "block_log");
-        fc::remove_all(data_dir / "block_log.index");
+        block_log::remove_files(data_dir / "block_log");
     }
 }
 
@@ -226,7 +234,23 @@ void database::close()
 
         chainbase::database::close();
 
+        _async_indexer.stop();
+
+        // the history store writes irreversible blocks in batches
+        if (_history_store)
+        {
+            try
+            {
+                _history_store->flush();
+            }
+            catch (const fc::exception& e)
+            {
+                elog("Could not flush the history store: ${e}", ("e", e.to_detail_string()));
+            }
+        }
+
         _block_log.close();
+        _block_cache.clear();
 
         _fork_db.reset();
     }
@@ -237,7 +261,7 @@ bool database::is_known_block(const block_id_type& id) const
 {
     try
     {
-        return fetch_block_by_id(id).valid();
+        return fetch_block_header_by_id(id).valid();
     }
     FC_CAPTURE_AND_RETHROW()
 }
@@ -279,10 +303,10 @@ block_id_type database::find_block_id_for_num(uint32_t block_num) const
         }
 
         // Next we query the block log.   Irreversible blocks are here.
-        auto b = _block_log.read_block_by_num(block_num);
-        if (b.valid())
+        auto r = _block_log.read_header_record_by_num(block_num);
+        if (r.valid())
         {
-            return b->id();
+            return r->id;
         }
 
         // Finally we query the fork DB.
@@ -305,62 +329,200 @@ block_id_type database::get_block_id_for_num(uint32_t block_num) const
 }
 
 optional<signed_block> database::fetch_block_by_id(const block_id_type& id) const
+{
+    optional<signed_block> result;
+
+    auto b = fetch_shared_block_by_id(id);
+    if (b)
+        result = *b;
+
+    return result;
+}
+
+optional<signed_block> database::fetch_block_by_number(uint32_t block_num) const
+{
+    optional<signed_block> result;
+
+    auto b = fetch_shared_block_by_number(block_num);
+    if (b)
+        result = *b;
+
+    return result;
+}
+
+block_cache::block_ptr database::fetch_shared_block_by_id(const block_id_type& id) const
 {
     try
     {
-        auto b = _fork_db.fetch_block(id);
-        if (!b)
+        auto cached = _block_cache.fetch_by_id(id);
+        if (cached)
         {
-            auto tmp = _block_log.read_block_by_num(protocol::block_header::num_from_id(id));
+            return cached;
+        }
 
-            if (tmp && tmp->id() == id)
-            {
-                return tmp;
-            }
+        auto item = _fork_db.fetch_block(id);
+        if (item)
+        {
+            // the block is owned by the fork item
+            return block_cache::block_ptr(item, &item->data);
+        }
 
-            tmp.reset();
-            return tmp;
+        auto tmp = _block_log.read_block_by_num(protocol::block_header::num_from_id(id));
+        if (tmp && tmp->id() == id)
+        {
+            // blocks from the log are irreversible, so it is safe to cache them by number
+            auto b = std::make_shared<const signed_block>(std::move(*tmp));
+            _block_cache.insert(b);
+            return b;
         }
 
-        return b->data;
+        return block_cache::block_ptr();
     }
     FC_CAPTURE_AND_RETHROW()
 }
 
-optional<signed_block> database::fetch_block_by_number(uint32_t block_num) const
+block_cache::block_ptr database::fetch_shared_block_by_number(uint32_t block_num) const
+{
+    try
+    {
+        auto cached = _block_cache.fetch_by_number(block_num);
+        if (cached)
+        {
+            return cached;
+        }
+
+        auto results = _fork_db.fetch_block_by_number(block_num);
+        if (results.size() == 1)
+        {
+            return block_cache::block_ptr(results[0], &results[0]->data);
+        }
+
+        auto tmp = _block_log.read_block_by_num(block_num);
+        if (tmp.valid())
+        {
+            auto b = std::make_shared<const signed_block>(std::move(*tmp));
+            _block_cache.insert(b);
+            return b;
+        }
+
+        return block_cache::block_ptr();
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+optional<block_header> database::fetch_block_header_by_id(const block_id_type& id) const
 {
     try
     {
-        optional<signed_block> b;
+        optional<block_header> h;
+
+        // only the header part of the shared block is copied
+        auto cached = _block_cache.fetch_by_id(id);
+        if (cached)
+        {
+            h = block_header(*cached);
+            return h;
+        }
+
+        auto b = _fork_db.fetch_block(id);
+        if (b)
+        {
+            h = block_header(b->data);
+            return h;
+        }
+
+        auto block_num = protocol::block_header::num_from_id(id);
+        auto r = _block_log.read_header_record_by_num(block_num);
+        if (r.valid() && r->id == id)
+        {
+            h = _block_log.read_header_by_num(block_num);
+        }
+
+        return h;
+    }
+    FC_CAPTURE_AND_RETHROW((id))
+}
+
+optional<block_header> database::fetch_block_header_by_number(uint32_t block_num) const
+{
+    try
+    {
+        optional<block_header> h;
+
+        auto cached = _block_cache.fetch_by_number(block_num);
+        if (cached)
+        {
+            h = block_header(*cached);
+            return h;
+        }
 
         auto results = _fork_db.fetch_block_by_number(block_num);
         if (results.size() == 1)
         {
-            b = results[0]->data;
+            h = block_header(results[0]->data);
         }
         else
         {
-            b = _block_log.read_block_by_num(block_num);
+            h = _block_log.read_header_by_num(block_num);
         }
 
-        return b;
+        return h;
     }
-    FC_LOG_AND_RETHROW()
+    FC_CAPTURE_AND_RETHROW((block_num))
+}
+
+std::vector<block_header_record>
+database::fetch_block_headers_by_time(time_point_sec start, time_point_sec end, uint32_t limit) const
+{
+    try
+    {
+        auto result = _block_log.read_header_records_by_time(start, end, limit);
+
+        // reversible blocks are not in the log yet
+        uint32_t log_head_num = _block_log.head() ? _block_log.head()->block_num() : 0;
+        for (uint32_t num = log_head_num + 1; num <= head_block_num() && result.size() < limit; ++num)
+        {
+            auto item = _fork_db.fetch_block_on_main_branch_by_number(num);
+            if (!item || item->data.timestamp >= end)
+            {
+                break;
+            }
+
+            if (item->data.timestamp >= start)
+            {
+                result.emplace_back(item->data);
+            }
+        }
+
+        return result;
+    }
+    FC_CAPTURE_AND_RETHROW((start)(end)(limit))
 }
 
 const signed_transaction database::get_recent_transaction(const transaction_id_type& trx_id) const
 {
     try
     {
+        const pending_transaction* pending = _pending_tx.find(trx_id);
+        if (pending != nullptr)
+            return pending->trx;
+
         auto& index = get_index<transaction_index>().indices().get<by_trx_id>();
         auto itr = index.find(trx_id);
         FC_ASSERT(itr != index.end());
-        signed_transaction trx;
-        fc::raw::unpack(itr->packed_trx, trx);
-        return trx;
-        ;
+
+        auto block = fetch_block_by_number(itr->block_num);
+        FC_ASSERT(block.valid(), "Block ${n} is not found.", ("n", itr->block_num));
+
+        for (const auto& trx : block->transactions)
+        {
+            if (trx.id() == trx_id)
+                return trx;
+        }
+
+        FC_THROW("Transaction is not found in block ${n}.", ("n", itr->block_num));
     }
-    FC_CAPTURE_AND_RETHROW()
+    FC_CAPTURE_AND_RETHROW((trx_id))
 }
 
 std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of_fork) const
@@ -529,25 +691,112 @@ bool database::before_last_checkpoint() const
  */
 bool database::push_block(const signed_block& new_block, uint32_t skip)
 {
-    // fc::time_point begin_time = fc::time_point::now();
+    return push_block(new_block, prevalidated_block(), skip);
+}
+
+bool database::push_block(const signed_block& new_block, const prevalidated_block& prevalidated, uint32_t skip)
+{
+    using graphene::utilities::trace_scope;
+    using graphene::utilities::tracer;
 
     bool result;
-    detail::with_skip_flags(*this, skip, [&]() {
+    detail::with_skip_flags(*this, skip | prevalidated.skip, [&]() {
+        const uint64_t lock_wait_start = tracer::instance().enabled() ? tracer::now_us() : 0;
         with_write_lock([&]() {
-            detail::without_pending_transactions(*this, std::move(_pending_tx), [&]() {
+            if (lock_wait_start != 0)
+            {
+                tracer::instance().record("write_lock_wait", "chain", lock_wait_start,
+                                          tracer::now_us() - lock_wait_start, new_block.block_num());
+            }
+
+            trace_scope trace("push_block", "chain", new_block.block_num());
+
+            detail::without_pending_transactions(*this, _pending_tx, new_block, [&]() {
                 try
                 {
-                    result = _push_block(new_block);
+                    result = _push_block(new_block, &prevalidated);
                 }
                 FC_CAPTURE_AND_RETHROW((new_block))
             });
         });
     });
 
-    // fc::time_point end_time = fc::time_point::now();
-    // fc::microseconds dt = end_time - begin_time;
-    // if( ( new_block.block_num() % 10000 ) == 0 )
-    //   ilog( "push_block ${b} took ${t} microseconds", ("b", new_block.block_num())("t", dt.count()) );
+    return result;
+}
+
+namespace {
+
+// validation of fewer transactions is not worth starting threads for
+const size_t parallel_validate_min_transactions = 8;
+
+const fc::flat_set<public_key_type>* find_signature_keys(const database::prevalidated_block* prevalidated,
+                                                         size_t trx_in_block)
+{
+    if (prevalidated == nullptr || trx_in_block >= prevalidated->signature_keys.size()
+        || !prevalidated->signature_keys[trx_in_block].valid())
+        return nullptr;
+
+    return &(*prevalidated->signature_keys[trx_in_block]);
+}
+}
+
+database::prevalidated_block
+database::prevalidate_block(const signed_block& b, const chain_id_type& chain_id, uint32_t skip)
+{
+    prevalidated_block result;
+
+    if (b.transaction_merkle_root == b.calculate_merkle_root())
+    {
+        result.skip |= skip_merkle_check;
+    }
+
+    if (!(skip & skip_witness_signature))
+    {
+        try
+        {
+            result.signee = public_key_type(b.signee());
+        }
+        catch (...)
+        {
+            // invalid signature is reported by push_block
+        }
+    }
+
+    const bool recover_keys = !(skip & (skip_transaction_signatures | skip_authority_check));
+
+    std::atomic<bool> valid(true);
+    const size_t count = b.transactions.size();
+    result.signature_keys.resize(count);
+    util::parallel_for(count, count < parallel_validate_min_transactions ? 1 : 0, [&](size_t i) {
+        const signed_transaction& trx = b.transactions[i];
+
+        try
+        {
+            trx.validate();
+        }
+        catch (...)
+        {
+            valid = false;
+        }
+
+        if (recover_keys)
+        {
+            try
+            {
+                result.signature_keys[i] = trx.get_signature_keys(chain_id);
+            }
+            catch (...)
+            {
+                // keys are recovered again on apply to report the error
+            }
+        }
+    });
+
+    if (valid)
+    {
+        result.skip |= skip_validate;
+    }
+
     return result;
 }
 
@@ -568,7 +817,7 @@ void database::_maybe_warn_multiple_production(uint32_t height) const
     return;
 }
 
-bool database::_push_block(const signed_block& new_block)
+bool database::_push_block(const signed_block& new_block, const prevalidated_block* prevalidated)
 {
     try
     {
@@ -604,8 +853,12 @@ bool database::_push_block(const signed_block& new_block)
                         optional<fc::exception> except;
                         try
                         {
+                            // only the new block could be prevalidated, other blocks of the fork were not checked
+                            bool is_new_block = (*ritr)->data.id() == new_block.id();
+                            uint32_t fork_skip = is_new_block ? skip : skip & ~(skip_merkle_check | skip_validate);
+
                             auto session = start_undo_session();
-                            apply_block((*ritr)->data, skip);
+                            apply_block((*ritr)->data, fork_skip, is_new_block ? prevalidated : nullptr);
                             session->push();
                         }
                         catch (const fc::exception& e)
@@ -651,7 +904,7 @@ bool database::_push_block(const signed_block& new_block)
         try
         {
             auto session = start_undo_session();
-            apply_block(new_block, skip);
+            apply_block(new_block, skip, prevalidated);
             session->push();
         }
         catch (const fc::exception& e)
@@ -697,12 +950,18 @@ void database::push_transaction(const signed_transaction& trx, uint32_t skip)
 }
 
 void database::_push_transaction(const signed_transaction& trx)
+{
+    _push_pending_transaction(pending_transaction(trx));
+}
+
+void database::_push_pending_transaction(pending_transaction&& ptx)
 {
     // If this is the first transaction pushed after applying a block, start a new undo session.
     // This allows us to quickly rewind to the clean state of the head block, in case a new block arrives.
     if (!_pending_tx_session.valid())
     {
         _pending_tx_session = start_undo_session();
+        _block_template.reset(head_block_id());
     }
 
     // Create a temporary undo session as a child of _pending_tx_session.
@@ -711,14 +970,38 @@ void database::_push_transaction(const signed_transaction& trx)
     // apply the changes.
 
     auto temp_session = start_undo_session();
-    _apply_transaction(trx);
-    _pending_tx.push_back(trx);
+
+    uint32_t skip = get_node_properties().skip_flags;
+    if (ptx.verified)
+    {
+        // transaction was already verified against authorities which were not changed since
+        detail::with_skip_flags(*this, skip | skip_validate | skip_transaction_signatures,
+                                [&]() { _apply_transaction(ptx.trx); });
+    }
+    else
+    {
+        // signatures are verified against authorities before the transaction changes them
+        fc::flat_set<account_name_type> authority_accounts = get_authority_accounts(ptx.trx);
+
+        _apply_transaction(ptx.trx);
+
+        if (!(skip & (skip_validate | skip_transaction_signatures | skip_authority_check)))
+        {
+            ptx.authority_accounts = std::move(authority_accounts);
+            ptx.verified = true;
+        }
+    }
 
     notify_changed_objects();
     // The transaction applied successfully. Merge its changes into the pending block session.
     for_each_index([&](chainbase::abstract_generic_index_i& item) { item.squash(); });
     temp_session->push();
 
+    const pending_transaction& pooled = _pending_tx.push(std::move(ptx));
+    _block_template.push(pooled, skip);
+
+    const signed_transaction& trx = pooled.trx;
+
     // notify anyone listening to pending transactions
     notify_on_pending_transaction(trx);
 }
@@ -764,61 +1047,101 @@ signed_block database::_generate_block(fc::time_point_sec when,
     signed_block pending_block;
 
     with_write_lock([&]() {
-        //
-        // The following code throws away existing pending_tx_session and
-        // rebuilds it by re-applying pending transactions.
-        //
-        // This rebuild is necessary because pending transactions' validity
-        // and semantics may have changed since they were received, because
-        // time-based semantics are evaluated based on the current block
-        // time.  These changes can only be reflected in the database when
-        // the value of the "when" variable is known, which means we need to
-        // re-apply pending transactions in this method.
-        //
-        _pending_tx_session.reset();
-        _pending_tx_session = start_undo_session();
-
-        uint64_t postponed_tx_count = 0;
-        // pop pending state (reset to head block state)
-        for (const signed_transaction& tx : _pending_tx)
+        if (_pending_tx_session.valid()
+            && _block_template.is_usable(head_block_id(), _pending_tx.size(), when,
+                                         maximum_block_size - max_block_header_size, skip))
+        {
+            // The pending session already holds every pending transaction applied on top of head
+            // with checks at least as strict as ours, re-applying them would give the same block.
+            pending_block.transactions.reserve(_pending_tx.size());
+            for (const pending_transaction& ptx : _pending_tx.transactions())
+            {
+                pending_block.transactions.push_back(ptx.trx);
+            }
+            pending_block.transaction_merkle_root = _block_template.merkle_root();
+        }
+        else
         {
-            // Only include transactions that have not expired yet for currently generating block,
-            // this should clear problem transactions and allow block production to continue
+            //
+            // The following code throws away existing pending_tx_session and
+            // rebuilds it by re-applying pending transactions.
+            //
+            // This rebuild is necessary because pending transactions' validity
+            // and semantics may have changed since they were received, because
+            // time-based semantics are evaluated based on the current block
+            // time.  These changes can only be reflected in the database when
+            // the value of the "when" variable is known, which means we need to
+            // re-apply pending transactions in this method.
+            //
+            _pending_tx_session.reset();
+            _pending_tx_session = start_undo_session();
+
+            uint64_t postponed_tx_count = 0;
+
+            // authorities updated by transactions left out of the block, transactions verified against them
+            // are checked again
+            fc::flat_set<account_name_type> skipped_updates;
+            auto skip_transaction = [&](const signed_transaction& tx) {
+                auto updates = mempool::get_authority_updates(tx);
+                skipped_updates.insert(updates.begin(), updates.end());
+            };
 
-            if (tx.expiration < when)
+            // pop pending state (reset to head block state)
+            for (const pending_transaction& ptx : _pending_tx.transactions())
             {
-                continue;
-            }
+                const signed_transaction& tx = ptx.trx;
 
-            uint64_t new_total_size = total_block_size + fc::raw::pack_size(tx);
+                // Only include transactions that have not expired yet for currently generating block,
+                // this should clear problem transactions and allow block production to continue
 
-            // postpone transaction if it would make block too big
-            if (new_total_size >= maximum_block_size)
-            {
-                postponed_tx_count++;
-                continue;
-            }
+                if (tx.expiration < when)
+                {
+                    skip_transaction(tx);
+                    continue;
+                }
 
-            try
-            {
-                auto temp_session = start_undo_session();
-                _apply_transaction(tx);
-                for_each_index([&](chainbase::abstract_generic_index_i& item) { item.squash(); });
-                temp_session->push();
+                uint64_t new_total_size = total_block_size + ptx.size;
 
-                total_block_size += fc::raw::pack_size(tx);
-                pending_block.transactions.push_back(tx);
+                // postpone transaction if it would make block too big
+                if (new_total_size >= maximum_block_size)
+                {
+                    skip_transaction(tx);
+                    postponed_tx_count++;
+                    continue;
+                }
+
+                try
+                {
+                    auto temp_session = start_undo_session();
+                    if (ptx.verified && !ptx.depends_on(skipped_updates))
+                    {
+                        detail::with_skip_flags(*this, skip | skip_validate | skip_transaction_signatures,
+                                                [&]() { _apply_transaction(tx); });
+                    }
+                    else
+                    {
+                        _apply_transaction(tx);
+                    }
+                    for_each_index([&](chainbase::abstract_generic_index_i& item) { item.squash(); });
+                    temp_session->push();
+
+                    total_block_size += ptx.size;
+                    pending_block.transactions.push_back(tx);
+                }
+                catch (const fc::exception& e)
+                {
+                    // Do nothing, transaction will not be re-applied
+                    skip_transaction(tx);
+                    // wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
+                    // wlog( "The transaction was ${t}", ("t", tx) );
+                }
             }
-            catch (const fc::exception& e)
+            if (postponed_tx_count > 0)
             {
-                // Do nothing, transaction will not be re-applied
-                // wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
-                // wlog( "The transaction was ${t}", ("t", tx) );
+                wlog("Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count));
             }
-        }
-        if (postponed_tx_count > 0)
-        {
-            wlog("Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count));
+
+            pending_block.transaction_merkle_root = pending_block.calculate_merkle_root();
         }
 
         _pending_tx_session.reset();
@@ -832,7 +1155,6 @@ signed_block database::_generate_block(fc::time_point_sec when,
 
     pending_block.previous = head_block_id();
     pending_block.timestamp = when;
-    pending_block.transaction_merkle_root = pending_block.calculate_merkle_root();
     pending_block.witness = witness_owner;
 
     const auto& witness = get_witness(witness_owner);
@@ -896,9 +1218,12 @@ void database::pop_block()
         SCORUM_ASSERT(head_block.valid(), pop_empty_chain, "there are no blocks to pop");
 
         _fork_db.pop_block();
+        _block_cache.remove(head_id);
 
         for_each_index([&](chainbase::abstract_generic_index_i& item) { item.undo(); });
 
+        _async_indexer.pop_block(head_block_num());
+
         _popped_tx.insert(_popped_tx.begin(), head_block->transactions.begin(), head_block->transactions.end());
     }
     FC_CAPTURE_AND_RETHROW()
@@ -911,10 +1236,16 @@ void database::clear_pending()
         assert((_pending_tx.size() == 0) || _pending_tx_session.valid());
         _pending_tx.clear();
         _pending_tx_session.reset();
+        _block_template.reset(block_id_type());
     }
     FC_CAPTURE_AND_RETHROW()
 }
 
+mempool_stats database::get_mempool_stats() const
+{
+    return _pending_tx.get_stats();
+}
+
 void database::notify_pre_apply_operation(operation_notification& note)
 {
     note.trx_id = _current_trx_id;
@@ -922,12 +1253,17 @@ void database::notify_pre_apply_operation(operation_notification& note)
     note.trx_in_block = _current_trx_in_block;
     note.op_in_trx = _current_op_in_trx;
 
+    if (_async_indexer.is_collecting())
+        _async_indexer.add_operation(note, head_block_time());
+
     SCORUM_TRY_NOTIFY(pre_apply_operation, note)
+    SCORUM_TRY_NOTIFY(pre_apply_operation_handlers, note)
 }
 
 void database::notify_post_apply_operation(const operation_notification& note)
 {
     SCORUM_TRY_NOTIFY(post_apply_operation, note)
+    SCORUM_TRY_NOTIFY(post_apply_operation_handlers, note)
 }
 
 inline void database::push_virtual_operation(const operation& op)
@@ -952,6 +1288,7 @@ inline void database::push_hf_operation(const operation& op)
 
 void database::notify_applied_block(const signed_block& block)
 {
+    graphene::utilities::trace_scope trace("applied_block_handlers", "plugins", block.block_num());
     SCORUM_TRY_NOTIFY(applied_block, block)
 }
 
@@ -1015,113 +1352,243 @@ uint32_t database::get_slot_at_time(fc::time_point_sec when) const
     return (when - first_slot_time).to_seconds() / SCORUM_BLOCK_INTERVAL + 1;
 }
 
-void database::process_vesting_withdrawals()
+void database::init_due_events()
+{
+    using due_time = optional<time_point_sec>;
+
+    // Transactions must have expired by at least two forking windows in order to be removed from the
+    // deduplication list, events compared with strict inequality are due one second after their time.
+    _due_events.set_handler(transaction_expiration,
+                            [this]() {
+                                const auto& idx = get_index<transaction_index>().indices().get<by_expiration>();
+                                return idx.empty() ? due_time() : due_time(idx.begin()->expiration + 1);
+                            },
+                            [this]() { remove(*get_index<transaction_index>().indices().get<by_expiration>().begin()); });
+
+    _due_events.set_handler(vesting_delegation_expiration,
+                            [this]() {
+                                const auto& idx = get_index<vesting_delegation_expiration_index, by_expiration>();
+                                return idx.empty() ? due_time() : due_time(idx.begin()->expiration + 1);
+                            },
+                            [this]() {
+                                const auto& delegation
+                                    = *get_index<vesting_delegation_expiration_index, by_expiration>().begin();
+
+                                modify(get_account(delegation.delegator), [&](account_object& a) {
+                                    a.delegated_vesting_shares -= delegation.vesting_shares;
+                                });
+
+                                push_virtual_operation(return_vesting_delegation_operation(
+                                    delegation.delegator, delegation.vesting_shares));
+
+                                remove(delegation);
+                            });
+
+    // contracts expire in order of deadlines, contracts with the same deadline in order of owners as they did
+    // before the deadline index, so refunds and their virtual operations keep that order
+    _due_events.set_handler(
+        atomicswap_contract_expiration,
+        [this]() {
+            const auto& idx = get_index<atomicswap_contract_index>().indices().get<by_deadline>();
+            return idx.empty() ? due_time() : due_time(idx.begin()->deadline);
+        },
+        [this]() {
+            obtain_service<dbs_atomicswap>().expire_contract(
+                *get_index<atomicswap_contract_index>().indices().get<by_deadline>().begin());
+        });
+
+    _due_events.set_handler(vesting_withdrawal,
+                            [this]() {
+                                const auto& idx = get_index<account_index>().indices().get<by_next_vesting_withdrawal>();
+                                return idx.empty() ? due_time() : due_time(idx.begin()->next_vesting_withdrawal);
+                            },
+                            [this]() {
+                                process_vesting_withdrawal(
+                                    *get_index<account_index>().indices().get<by_next_vesting_withdrawal>().begin());
+                            });
+
+    _due_events.set_handler(
+        account_recovery_request_expiration,
+        [this]() {
+            const auto& idx = get_index<account_recovery_request_index>().indices().get<by_expiration>();
+            return idx.empty() ? due_time() : due_time(idx.begin()->expires);
+        },
+        [this]() { remove(*get_index<account_recovery_request_index>().indices().get<by_expiration>().begin()); });
+
+    // historical authorities are created in order of their last valid time, so the index by id is ordered by time
+    _due_events.set_handler(owner_authority_history_expiration,
+                            [this]() {
+                                const auto& idx = get_index<owner_authority_history_index>().indices();
+                                return idx.empty() ? due_time()
+                                                   : due_time(time_point_sec(idx.begin()->last_valid_time
+                                                                             + SCORUM_OWNER_AUTH_RECOVERY_PERIOD)
+                                                              + 1);
+                            },
+                            [this]() { remove(*get_index<owner_authority_history_index>().indices().begin()); });
+
+    _due_events.set_handler(
+        recovery_account_change,
+        [this]() {
+            const auto& idx = get_index<change_recovery_account_request_index>().indices().get<by_effective_date>();
+            return idx.empty() ? due_time() : due_time(idx.begin()->effective_on);
+        },
+        [this]() {
+            const auto& request
+                = *get_index<change_recovery_account_request_index>().indices().get<by_effective_date>().begin();
+
+            modify(get_account(request.account_to_recover),
+                   [&](account_object& a) { a.recovery_account = request.recovery_account; });
+
+            remove(request);
+        });
+
+    _due_events.set_handler(escrow_ratification_expiration,
+                            [this]() {
+                                const auto& idx = get_index<escrow_index>().indices().get<by_ratification_deadline>();
+                                auto itr = idx.lower_bound(false);
+                                return (itr == idx.end() || itr->is_approved()) ? due_time()
+                                                                                : due_time(itr->ratification_deadline);
+                            },
+                            [this]() {
+                                const auto& old_escrow
+                                    = *get_index<escrow_index>().indices().get<by_ratification_deadline>().lower_bound(
+                                        false);
+
+                                const auto& from_account = get_account(old_escrow.from);
+                                adjust_balance(from_account, old_escrow.scorum_balance);
+                                adjust_balance(from_account, old_escrow.pending_fee);
+
+                                obtain_service<dbs_escrow>().remove(old_escrow);
+                            });
+
+    _due_events.set_handler(
+        voting_rights_decline,
+        [this]() {
+            const auto& idx = get_index<decline_voting_rights_request_index>().indices().get<by_effective_date>();
+            return idx.empty() ? due_time() : due_time(idx.begin()->effective_date);
+        },
+        [this]() {
+            process_decline_voting_rights(
+                *get_index<decline_voting_rights_request_index>().indices().get<by_effective_date>().begin());
+        });
+
+    _due_events.set_handler(proposal_expiration,
+                            [this]() {
+                                const auto& idx = get_index<proposal_object_index>().indices().get<by_expiration>();
+                                return idx.empty() ? due_time() : due_time(idx.begin()->expiration + 1);
+                            },
+                            [this]() {
+                                obtain_service<dbs_proposal>().remove(
+                                    *get_index<proposal_object_index>().indices().get<by_expiration>().begin());
+                            });
+}
+
+void database::process_vesting_withdrawal(const account_object& from_account)
 {
     // clang-format off
     dbs_account& account_service = obtain_service<dbs_account>();
 
-    const auto& widx = get_index<account_index>().indices().get<by_next_vesting_withdrawal>();
     const auto& didx = get_index<withdraw_vesting_route_index>().indices().get<by_withdraw_route>();
 
     const auto& cprops = get_dynamic_global_properties();
 
-    for (auto current = widx.begin(); current != widx.end() && current->next_vesting_withdrawal <= head_block_time();)
+    // deposits from withdrawals processed earlier in this block
+    _account_deltas.flush(from_account);
+
+    /**
+     *  Let T = total tokens in vesting fund
+     *  Let V = total vesting shares
+     *  Let v = total vesting shares being cashed out
+     *
+     *  The user may withdraw  vT / V tokens
+     */
+    share_type to_withdraw;
+    if (from_account.to_withdraw - from_account.withdrawn < from_account.vesting_withdraw_rate.amount)
+    {
+        to_withdraw = std::min(from_account.vesting_shares.amount, from_account.to_withdraw % from_account.vesting_withdraw_rate.amount);
+    }
+    else
     {
-        const auto& from_account = *(current++);
+        to_withdraw = std::min(from_account.vesting_shares.amount, from_account.vesting_withdraw_rate.amount);
+    }
 
-        /**
-         *  Let T = total tokens in vesting fund
-         *  Let V = total vesting shares
-         *  Let v = total vesting shares being cashed out
-         *
-         *  The user may withdraw  vT / V tokens
-         */
-        share_type to_withdraw;
-        if (from_account.to_withdraw - from_account.withdrawn < from_account.vesting_withdraw_rate.amount)
-        {
-            to_withdraw = std::min(from_account.vesting_shares.amount, from_account.to_withdraw % from_account.vesting_withdraw_rate.amount);
-        }
-        else
-        {
-            to_withdraw = std::min(from_account.vesting_shares.amount, from_account.vesting_withdraw_rate.amount);
-        }
+    share_type vests_deposited_as_vests = 0;
+    share_type vests_deposited_as_scorum = 0;
 
-        share_type vests_deposited_as_vests = 0;
-        share_type vests_deposited_as_scorum = 0;
+    for (auto itr = didx.upper_bound(boost::make_tuple(from_account.id, account_id_type())); itr != didx.end() && itr->from_account == from_account.id; ++itr)
+    {
+        share_type to_deposit = ((fc::uint128_t(to_withdraw.value) * itr->percent) / SCORUM_100_PERCENT).to_uint64();
 
-        for (auto itr = didx.upper_bound(boost::make_tuple(from_account.id, account_id_type())); itr != didx.end() && itr->from_account == from_account.id; ++itr)
+        if (to_deposit > 0)
         {
-            share_type to_deposit = ((fc::uint128_t(to_withdraw.value) * itr->percent) / SCORUM_100_PERCENT).to_uint64();
+            const auto& to_account = get(itr->to_account);
 
-            if (to_deposit > 0)
+            if (itr->auto_vest)//withdraw SP
             {
-                const auto& to_account = get(itr->to_account);
+                vests_deposited_as_vests += to_deposit;
 
-                if (itr->auto_vest)//withdraw SP
-                {
-                    vests_deposited_as_vests += to_deposit;
+                _account_deltas.increase_vesting_shares(to_account, asset(to_deposit, VESTS_SYMBOL));
 
-                    modify(to_account, [&](account_object& a) { a.vesting_shares.amount += to_deposit; });
-
-                    account_service.adjust_proxied_witness_votes(to_account, to_deposit);
-
-                    push_virtual_operation(fill_vesting_withdraw_operation(from_account.name, to_account.name,
-                                                                           asset(to_deposit, VESTS_SYMBOL),
-                                                                           asset(to_deposit, VESTS_SYMBOL)));
-                }
-                else //convert SP to SCR and withdraw SCR
-                {
-                    vests_deposited_as_scorum += to_deposit;
+                push_virtual_operation(fill_vesting_withdraw_operation(from_account.name, to_account.name,
+                                                                       asset(to_deposit, VESTS_SYMBOL),
+                                                                       asset(to_deposit, VESTS_SYMBOL)));
+            }
+            else //convert SP to SCR and withdraw SCR
+            {
+                vests_deposited_as_scorum += to_deposit;
 
-                    auto converted_scorum = asset(to_deposit, VESTS_SYMBOL) * cprops.get_vesting_share_price();
+                auto converted_scorum = asset(to_deposit, VESTS_SYMBOL) * cprops.get_vesting_share_price();
 
-                    modify(to_account, [&](account_object& a) { a.balance += converted_scorum; });
+                _account_deltas.increase_balance(to_account, converted_scorum);
 
-                    modify(cprops, [&](dynamic_global_property_object& o) {
-                        o.total_vesting_shares.amount -= to_deposit;
-                    });
+                modify(cprops, [&](dynamic_global_property_object& o) {
+                    o.total_vesting_shares.amount -= to_deposit;
+                });
 
-                    push_virtual_operation(fill_vesting_withdraw_operation(from_account.name, to_account.name, 
-                                                                           asset(to_deposit, VESTS_SYMBOL), 
-                                                                           converted_scorum));
-                }
+                push_virtual_operation(fill_vesting_withdraw_operation(from_account.name, to_account.name, 
+                                                                       asset(to_deposit, VESTS_SYMBOL), 
+                                                                       converted_scorum));
             }
         }
+    }
 
-        share_type to_convert = to_withdraw - vests_deposited_as_scorum - vests_deposited_as_vests;
-        FC_ASSERT(to_convert >= 0, "Deposited more vests than were supposed to be withdrawn");
+    share_type to_convert = to_withdraw - vests_deposited_as_scorum - vests_deposited_as_vests;
+    FC_ASSERT(to_convert >= 0, "Deposited more vests than were supposed to be withdrawn");
 
-        auto converted_scorum = asset(to_convert, VESTS_SYMBOL) * cprops.get_vesting_share_price();
+    auto converted_scorum = asset(to_convert, VESTS_SYMBOL) * cprops.get_vesting_share_price();
 
-        modify(from_account, [&](account_object& a) {
-            a.vesting_shares.amount -= to_withdraw;
-            a.balance += converted_scorum;
-            a.withdrawn += to_withdraw;
+    // a route can lead back to the withdrawing account
+    _account_deltas.flush(from_account);
 
-            if (a.withdrawn >= a.to_withdraw || a.vesting_shares.amount == 0)
-            {
-                a.vesting_withdraw_rate.amount = 0;
-                a.next_vesting_withdrawal = fc::time_point_sec::maximum();
-            }
-            else
-            {
-                a.next_vesting_withdrawal += fc::seconds(SCORUM_VESTING_WITHDRAW_INTERVAL_SECONDS);
-            }
-        });
+    account_service.increase_balance(from_account, converted_scorum);
 
-        modify(cprops, [&](dynamic_global_property_object& o) {
-            o.total_vesting_shares.amount -= to_convert;
-        });
+    modify(from_account, [&](account_object& a) {
+        a.vesting_shares.amount -= to_withdraw;
+        a.withdrawn += to_withdraw;
 
-        if (to_withdraw > 0)
+        if (a.withdrawn >= a.to_withdraw || a.vesting_shares.amount == 0)
+        {
+            a.vesting_withdraw_rate.amount = 0;
+            a.next_vesting_withdrawal = fc::time_point_sec::maximum();
+        }
+        else
         {
-            account_service.adjust_proxied_witness_votes(from_account, -to_withdraw);
+            a.next_vesting_withdrawal += fc::seconds(SCORUM_VESTING_WITHDRAW_INTERVAL_SECONDS);
         }
+    });
+
+    modify(cprops, [&](dynamic_global_property_object& o) {
+        o.total_vesting_shares.amount -= to_convert;
+    });
 
-        push_virtual_operation(fill_vesting_withdraw_operation(from_account.name, from_account.name,
-                                                               asset(to_withdraw, VESTS_SYMBOL), converted_scorum));
+    if (to_withdraw > 0)
+    {
+        account_service.adjust_proxied_witness_votes(from_account, -to_withdraw);
     }
 
+    push_virtual_operation(fill_vesting_withdraw_operation(from_account.name, from_account.name,
+                                                           asset(to_withdraw, VESTS_SYMBOL), converted_scorum));
+
     // clang-format on
 }
 
@@ -1141,19 +1608,57 @@ void database::adjust_total_payout(const comment_object& cur,
     /// TODO: potentially modify author's total payout numbers as well
 }
 
+namespace {
+
+share_type get_curation_tokens(const share_type& reward_tokens)
+{
+    return ((uint128_t(reward_tokens.value) * SCORUM_CURATION_REWARD_PERCENT) / SCORUM_100_PERCENT).to_uint64();
+}
+
+// cashout of fewer comments is not worth starting threads for
+const size_t parallel_curation_min_comments = 16;
+}
+
 /**
  *  This method will iterate through all comment_vote_objects and give them
  *  (max_rewards * weight) / c.total_vote_weight.
- *
+ */
+database::curator_claims database::get_curator_claims(const comment_object& c, const share_type& max_rewards) const
+{
+    try
+    {
+        curator_claims claims;
+
+        if (c.allow_curation_rewards && c.total_vote_weight > 0)
+        {
+            uint128_t total_weight(c.total_vote_weight);
+
+            const auto& cvidx = get_index<comment_vote_index>().indices().get<by_comment_weight_voter>();
+            auto itr = cvidx.lower_bound(c.id);
+            while (itr != cvidx.end() && itr->comment == c.id)
+            {
+                uint128_t weight(itr->weight);
+                auto claim = ((max_rewards.value * weight) / total_weight).to_uint64();
+                if (claim > 0) // min_amt is non-zero satoshis
+                {
+                    claims.emplace_back(itr->voter, claim);
+                }
+                ++itr;
+            }
+        }
+
+        return claims;
+    }
+    FC_CAPTURE_AND_RETHROW()
+}
+
+/**
  *  @returns unclaimed rewards.
  */
-share_type database::pay_curators(const comment_object& c, share_type& max_rewards)
+share_type database::pay_curators(const comment_object& c, const curator_claims& claims, share_type& max_rewards)
 {
-    dbs_account& account_service = obtain_service<dbs_account>();
     try
     {
-        uint128_t total_weight(c.total_vote_weight);
-        // edump( (total_weight)(max_rewards) );
         share_type unclaimed_rewards = max_rewards;
 
         if (!c.allow_curation_rewards)
@@ -1163,28 +1668,18 @@ share_type database::pay_curators(const comment_object& c, share_type& max_rewar
             unclaimed_rewards = 0;
             max_rewards = 0;
         }
-        else if (c.total_vote_weight > 0)
-        {
-            const auto& cvidx = get_index<comment_vote_index>().indices().get<by_comment_weight_voter>();
-            auto itr = cvidx.lower_bound(c.id);
-            while (itr != cvidx.end() && itr->comment == c.id)
+        else
+        {
+            for (const auto& claim : claims)
             {
-                uint128_t weight(itr->weight);
-                auto claim = ((max_rewards.value * weight) / total_weight).to_uint64();
-                if (claim > 0) // min_amt is non-zero satoshis
-                {
-                    unclaimed_rewards -= claim;
-                    const auto& voter = get(itr->voter);
-                    auto reward = account_service.create_vesting(voter, asset(claim, SCORUM_SYMBOL));
+                unclaimed_rewards -= claim.second;
+                const auto& voter = get(claim.first);
+                auto reward = _account_deltas.create_vesting(voter, asset(claim.second, SCORUM_SYMBOL));
 
-                    push_virtual_operation(
-                        curation_reward_operation(voter.name, reward, c.author, fc::to_string(c.permlink)));
+                push_virtual_operation(
+                    curation_reward_operation(voter.name, reward, c.author, fc::to_string(c.permlink)));
 
-#ifndef IS_LOW_MEM
-                    modify(voter, [&](account_object& a) { a.curation_rewards += claim; });
-#endif
-                }
-                ++itr;
+                _account_deltas.increase_curation_rewards(voter, claim.second);
             }
         }
         max_rewards -= unclaimed_rewards;
@@ -1194,19 +1689,19 @@ share_type database::pay_curators(const comment_object& c, share_type& max_rewar
     FC_CAPTURE_AND_RETHROW()
 }
 
-share_type database::cashout_comment_helper(const share_type& reward_tokens, const comment_object& comment)
+share_type database::cashout_comment_helper(const share_type& reward_tokens,
+                                            const comment_object& comment,
+                                            const curator_claims& claims)
 {
     try
     {
         if (reward_tokens > 0)
         {
             // clang-format off
-            dbs_account& account_service = obtain_service<dbs_account>();
-
-            share_type curation_tokens = ((uint128_t(reward_tokens.value) * SCORUM_CURATION_REWARD_PERCENT) / SCORUM_100_PERCENT).to_uint64();
+            share_type curation_tokens = get_curation_tokens(reward_tokens);
             share_type author_tokens = reward_tokens - curation_tokens;
 
-            author_tokens += pay_curators(comment, curation_tokens); //curation_tokens can be changed inside pay_curators()
+            author_tokens += pay_curators(comment, claims, curation_tokens); //curation_tokens can be changed inside pay_curators()
 
             share_type claimed_reward = author_tokens + curation_tokens;
 
@@ -1214,7 +1709,7 @@ share_type database::cashout_comment_helper(const share_type& reward_tokens, con
             for (auto& b : comment.beneficiaries)
             {
                 auto benefactor_tokens = (author_tokens * b.weight) / SCORUM_100_PERCENT;
-                asset vest_created = account_service.create_vesting(get_account(b.account), asset(benefactor_tokens, SCORUM_SYMBOL));
+                asset vest_created = _account_deltas.create_vesting(get_account(b.account), asset(benefactor_tokens, SCORUM_SYMBOL));
                 push_virtual_operation(comment_benefactor_reward_operation(b.account, comment.author, fc::to_string(comment.permlink), vest_created));
                 total_beneficiary += benefactor_tokens;
             }
@@ -1227,16 +1722,15 @@ share_type database::cashout_comment_helper(const share_type& reward_tokens, con
             auto vesting_scorum = asset((author_tokens - payout_scorum.amount), SCORUM_SYMBOL);
 
             const auto& author = get_account(comment.author);
-            account_service.increase_balance(author, payout_scorum);
-            asset vest_created = account_service.create_vesting(author, vesting_scorum);
+            _account_deltas.increase_balance(author, payout_scorum);
+            asset vest_created = _account_deltas.create_vesting(author, vesting_scorum);
 
             push_virtual_operation( author_reward_operation(comment.author, fc::to_string(comment.permlink), payout_scorum, vest_created));
             push_virtual_operation(comment_reward_operation(comment.author, fc::to_string(comment.permlink), asset(claimed_reward, SCORUM_SYMBOL)));
 
 #ifndef IS_LOW_MEM
             modify(comment, [&](comment_object& c) { c.author_rewards += author_tokens; });
-
-            modify(author, [&](account_object& a) { a.posting_rewards += author_tokens; });
+            _account_deltas.increase_posting_rewards(author, author_tokens);
 #endif
             return claimed_reward;
             // clang-format on
@@ -1261,16 +1755,18 @@ void database::process_comment_cashout()
 
     const auto& cidx = get_index<comment_index>().indices().get<by_cashout_time>();
 
-    //  add all rshares about to be cashed out to the reward funds. This ensures equal satoshi per rshare payment
-    uint128_t recent_claims = rf.recent_claims;
+    // collect comments about to be cashed out, rewards are evaluated for the whole batch before any write
+    std::vector<std::reference_wrapper<const comment_object>> comments;
+    util::comment_reward_batch batch;
     for (auto current = cidx.begin(); current != cidx.end() && current->cashout_time <= head_block_time(); ++current)
     {
-        if (current->net_rshares > 0)
-        {
-            recent_claims += util::evaluate_reward_curve(current->net_rshares.value, rf.author_reward_curve);
-        }
+        comments.emplace_back(*current);
+        batch.push_back(current->net_rshares, current->reward_weight, current->max_accepted_payout);
     }
 
+    //  add all rshares about to be cashed out to the reward funds. This ensures equal satoshi per rshare payment
+    uint128_t recent_claims = rf.recent_claims + batch.evaluate_claims(rf.author_reward_curve);
+
     /*
      * Payout all comments
      *
@@ -1278,26 +1774,28 @@ void database::process_comment_cashout()
      * The helper only does token allocation based on curation rewards and the SBD
      * global %, etc.
      *
-     * Each context is used by get_rshare_reward to determine what part of each budget
-     * the comment is entitled to. Each payout is done
-     * against a reward fund state that is snapshotted before all payouts in the block.
+     * Batch payouts determine what part of the budget each comment is entitled to.
+     * Each payout is done against a reward fund state that is snapshotted before all payouts in the block.
      */
+    batch.evaluate_payouts(recent_claims, rf.reward_balance);
+
+    // votes are only read here, so curation rewards of comments are split between voters in parallel
+    std::vector<curator_claims> claims(comments.size());
+    util::parallel_for(comments.size(), comments.size() < parallel_curation_min_comments ? 1 : 0, [&](size_t i) {
+        if (batch.payouts[i] > 0)
+        {
+            claims[i] = get_curator_claims(comments[i], get_curation_tokens(batch.payouts[i]));
+        }
+    });
+
     asset scorum_awarded = asset(0, SCORUM_SYMBOL);
-    for (auto current = cidx.begin(); current != cidx.end() && current->cashout_time <= head_block_time();)
+    for (size_t i = 0; i < comments.size(); ++i)
     {
-        const comment_object& comment = *(current++);
+        const comment_object& comment = comments[i];
 
         if (comment.net_rshares > 0)
         {
-            util::comment_reward_context ctx;
-            ctx.total_reward_shares2 = recent_claims;
-            ctx.total_reward_fund_scorum = rf.reward_balance;
-            ctx.reward_curve = rf.author_reward_curve;
-            ctx.rshares = comment.net_rshares;
-            ctx.reward_weight = comment.reward_weight;
-            ctx.max_scr = comment.max_accepted_payout;
-
-            scorum_awarded.amount += cashout_comment_helper(util::get_rshare_reward(ctx), comment);
+            scorum_awarded.amount += cashout_comment_helper(batch.payouts[i], comment, claims[i]);
         }
 
         modify(comment, [&](comment_object& c) {
@@ -1335,6 +1833,8 @@ void database::process_comment_cashout()
         rfo.recent_claims = recent_claims;
         rfo.reward_balance -= scorum_awarded;
     });
+
+    _account_deltas.flush();
 }
 
 /**
@@ -1354,11 +1854,7 @@ void database::process_funds()
     // We just get per block reward from reward pool and expect that after initial supply is handed out(fund budget is
     // over) reward budgets will be created by our users.
 
-    asset budgets_reward = asset(0, SCORUM_SYMBOL);
-    for (const budget_object& budget : budget_service.get_budgets())
-    {
-        budgets_reward += budget_service.allocate_cash(budget);
-    }
+    asset budgets_reward = budget_service.allocate_cash();
     reward_service.increase_pool_ballance(budgets_reward);
 
     auto total_block_reward = reward_service.take_block_reward();
@@ -1386,92 +1882,29 @@ void database::process_funds()
     push_virtual_operation(producer_reward_operation(cwit.owner, producer_reward));
 }
 
-void database::account_recovery_processing()
+void database::process_decline_voting_rights(const decline_voting_rights_request_object& request)
 {
-    // Clear expired recovery requests
-    const auto& rec_req_idx = get_index<account_recovery_request_index>().indices().get<by_expiration>();
-    auto rec_req = rec_req_idx.begin();
-
-    while (rec_req != rec_req_idx.end() && rec_req->expires <= head_block_time())
-    {
-        remove(*rec_req);
-        rec_req = rec_req_idx.begin();
-    }
-
-    // Clear invalid historical authorities
-    const auto& hist_idx = get_index<owner_authority_history_index>().indices(); // by id
-    auto hist = hist_idx.begin();
-
-    while (hist != hist_idx.end()
-           && time_point_sec(hist->last_valid_time + SCORUM_OWNER_AUTH_RECOVERY_PERIOD) < head_block_time())
-    {
-        remove(*hist);
-        hist = hist_idx.begin();
-    }
-
-    // Apply effective recovery_account changes
-    const auto& change_req_idx = get_index<change_recovery_account_request_index>().indices().get<by_effective_date>();
-    auto change_req = change_req_idx.begin();
-
-    while (change_req != change_req_idx.end() && change_req->effective_on <= head_block_time())
-    {
-        modify(get_account(change_req->account_to_recover),
-               [&](account_object& a) { a.recovery_account = change_req->recovery_account; });
-
-        remove(*change_req);
-        change_req = change_req_idx.begin();
-    }
-}
+    dbs_account& account_service = obtain_service<dbs_account>();
 
-void database::expire_escrow_ratification()
-{
-    const auto& escrow_idx = get_index<escrow_index>().indices().get<by_ratification_deadline>();
-    auto escrow_itr = escrow_idx.lower_bound(false);
+    const auto& account = get(request.account);
 
-    while (escrow_itr != escrow_idx.end() && !escrow_itr->is_approved()
-           && escrow_itr->ratification_deadline <= head_block_time())
+    /// remove all current votes
+    std::array<share_type, SCORUM_MAX_PROXY_RECURSION_DEPTH + 1> delta;
+    delta[0] = -account.vesting_shares.amount;
+    for (int i = 0; i < SCORUM_MAX_PROXY_RECURSION_DEPTH; ++i)
     {
-        const auto& old_escrow = *escrow_itr;
-        ++escrow_itr;
-
-        const auto& from_account = get_account(old_escrow.from);
-        adjust_balance(from_account, old_escrow.scorum_balance);
-        adjust_balance(from_account, old_escrow.pending_fee);
-
-        remove(old_escrow);
+        delta[i + 1] = -account.proxied_vsf_votes[i];
     }
-}
-
-void database::process_decline_voting_rights()
-{
-    const auto& request_idx = get_index<decline_voting_rights_request_index>().indices().get<by_effective_date>();
-    auto itr = request_idx.begin();
-
-    dbs_account& account_service = obtain_service<dbs_account>();
-
-    while (itr != request_idx.end() && itr->effective_date <= head_block_time())
-    {
-        const auto& account = get(itr->account);
-
-        /// remove all current votes
-        std::array<share_type, SCORUM_MAX_PROXY_RECURSION_DEPTH + 1> delta;
-        delta[0] = -account.vesting_shares.amount;
-        for (int i = 0; i < SCORUM_MAX_PROXY_RECURSION_DEPTH; ++i)
-        {
-            delta[i + 1] = -account.proxied_vsf_votes[i];
-        }
-        account_service.adjust_proxied_witness_votes(account, delta);
+    account_service.adjust_proxied_witness_votes(account, delta);
 
-        account_service.clear_witness_votes(account);
+    account_service.clear_witness_votes(account);
 
-        modify(get(itr->account), [&](account_object& a) {
-            a.can_vote = false;
-            a.proxy = SCORUM_PROXY_TO_SELF_ACCOUNT;
-        });
+    modify(get(request.account), [&](account_object& a) {
+        a.can_vote = false;
+        a.proxy = SCORUM_PROXY_TO_SELF_ACCOUNT;
+    });
 
-        remove(*itr);
-        itr = request_idx.begin();
-    }
+    remove(request);
 }
 
 time_point_sec database::head_block_time() const
@@ -1647,14 +2080,48 @@ void database::set_flush_interval(uint32_t flush_blocks)
     _next_flush_block = 0;
 }
 
+void database::set_block_log_segment_size(uint32_t blocks)
+{
+    _block_log_segment_blocks = blocks;
+}
+
+void database::set_block_log_retain_blocks(uint32_t blocks)
+{
+    _block_log_retain_blocks = blocks;
+}
+
+void database::set_block_cache_size(uint32_t blocks)
+{
+    _block_cache.set_capacity(blocks);
+}
+
+block_cache_stats database::get_block_cache_stats() const
+{
+    return _block_cache.get_stats();
+}
+
+void database::set_slow_block_threshold(uint32_t ms)
+{
+    _block_timer.set_slow_block_threshold((uint64_t)ms * 1000);
+}
+
+block_timing_stats database::get_block_timing_stats() const
+{
+    return _block_timer.get_stats();
+}
+
+void database::set_operation_profile_interval(uint32_t blocks)
+{
+    _operation_profile_blocks = blocks;
+    _operation_profiler.enable();
+}
+
 //////////////////// private methods ////////////////////
 
-void database::apply_block(const signed_block& next_block, uint32_t skip)
+void database::apply_block(const signed_block& next_block, uint32_t skip, const prevalidated_block* prevalidated)
 {
     try
     {
-        // fc::time_point begin_time = fc::time_point::now();
-
         auto block_num = next_block.block_num();
         if (_checkpoints.size() && _checkpoints.rbegin()->second != block_id_type())
         {
@@ -1671,42 +2138,104 @@ void database::apply_block(const signed_block& next_block, uint32_t skip)
                     | skip_undo_history_check | skip_witness_schedule_check | skip_validate | skip_validate_invariants;
         }
 
-        detail::with_skip_flags(*this, skip, [&]() { _apply_block(next_block); });
+        _block_timer.start_block();
+
+        {
+            graphene::utilities::trace_scope trace("apply_block", "chain", block_num);
+            try
+            {
+                detail::with_skip_flags(*this, skip, [&]() { _apply_block(next_block, prevalidated); });
+            }
+            catch (...)
+            {
+                _async_indexer.abort_block();
+                _account_deltas.clear();
+                throw;
+            }
+        }
 
-        /*try
+        const uint64_t block_time_us = _block_timer.end_block(block_num);
+        if (_block_timer.is_slow(block_time_us))
         {
-        /// check invariants
-        if( is_producing() || !( skip & skip_validate_invariants ) )
-           validate_invariants();
+            wlog("Block ${b} took ${t} ms to apply with ${n} transactions, ${phases}",
+                 ("b", block_num)("t", block_time_us / 1000)("n", next_block.transactions.size())(
+                     "phases", _block_timer.get_last_block_breakdown()));
+
+            // the trace is written out of the write lock when spans of pushing the block are closed
+            if (graphene::utilities::tracer::instance().enabled())
+            {
+                graphene::utilities::tracer::instance().dump_after_scopes("slow-block-" + std::to_string(block_num));
+            }
         }
-        FC_CAPTURE_AND_RETHROW( (next_block) );*/
 
-        // fc::time_point end_time = fc::time_point::now();
-        // fc::microseconds dt = end_time - begin_time;
-        if (_flush_blocks != 0)
+        try
         {
-            if (_next_flush_block == 0)
+            // running totals make the supply check cheap enough for every block
+            if (!(skip & skip_validate_invariants))
+            {
+                validate_invariants();
+            }
+
+            if (_flush_blocks != 0)
             {
-                uint32_t lep = block_num + 1 + _flush_blocks * 9 / 10;
-                uint32_t rep = block_num + 1 + _flush_blocks;
+                if (_next_flush_block == 0)
+                {
+                    uint32_t lep = block_num + 1 + _flush_blocks * 9 / 10;
+                    uint32_t rep = block_num + 1 + _flush_blocks;
+
+                    // use time_point::now() as RNG source to pick block randomly between lep and rep
+                    uint32_t span = rep - lep;
+                    uint32_t x = lep;
+                    if (span > 0)
+                    {
+                        uint64_t now = uint64_t(fc::time_point::now().time_since_epoch().count());
+                        x += now % span;
+                    }
+                    _next_flush_block = x;
+                    // ilog( "Next flush scheduled at block ${b}", ("b", x) );
+                }
 
-                // use time_point::now() as RNG source to pick block randomly between lep and rep
-                uint32_t span = rep - lep;
-                uint32_t x = lep;
-                if (span > 0)
+                if (_next_flush_block == block_num)
                 {
-                    uint64_t now = uint64_t(fc::time_point::now().time_since_epoch().count());
-                    x += now % span;
+                    _next_flush_block = 0;
+                    // ilog( "Flushing database shared memory at block ${b}", ("b", block_num) );
+                    graphene::utilities::trace_scope trace("flush", "chain", block_num);
+                    chainbase::database::flush();
+
+                    // blocks below the flushed irreversible state are not needed to reopen the database
+                    uint32_t last_irreversible_block_num = get_dynamic_global_properties().last_irreversible_block_num;
+                    if (_block_log_retain_blocks != 0 && last_irreversible_block_num > _block_log_retain_blocks)
+                    {
+                        _block_log.prune(last_irreversible_block_num - _block_log_retain_blocks);
+                    }
                 }
-                _next_flush_block = x;
-                // ilog( "Next flush scheduled at block ${b}", ("b", x) );
             }
+        }
+        catch (...)
+        {
+            _async_indexer.abort_block();
+            throw;
+        }
+
+        // only blocks which passed all checks are cached, there are no readers of the cache while replaying
+        // the block log
+        if (!(skip & skip_block_log))
+        {
+            _block_cache.insert(next_block);
+        }
 
-            if (_next_flush_block == block_num)
+        // operations are handed to consumers only after every step of the block which can fail has passed
+        _async_indexer.end_block(get_dynamic_global_properties().last_irreversible_block_num);
+
+        if (_operation_profile_blocks != 0 && block_num % _operation_profile_blocks == 0)
+        {
+            for (const operation_profile& profile : _operation_profiler.get_profiles())
             {
-                _next_flush_block = 0;
-                // ilog( "Flushing database shared memory at block ${b}", ("b", block_num) );
-                chainbase::database::flush();
+                ilog("${name}: ${count} ops, total ${total} ns, avg ${avg} ns, p99 ${p99} ns, max ${max} ns, "
+                     "handlers ${pre}/${post} ns",
+                     ("name", profile.name)("count", profile.count)("total", profile.total_ns)("avg", profile.avg_ns)(
+                         "p99", profile.p99_ns)("max", profile.max_ns)("pre", profile.pre_notify_ns)(
+                         "post", profile.post_notify_ns));
             }
         }
 
@@ -1739,8 +2268,11 @@ void database::show_free_memory(bool force)
 #endif
 }
 
-void database::_apply_block(const signed_block& next_block)
+void database::_apply_block(const signed_block& next_block, const prevalidated_block* prevalidated)
 {
+    // drop changes buffered by a block that failed to apply, its state is already undone
+    _account_deltas.clear();
+
     try
     {
         uint32_t next_block_num = next_block.block_num();
@@ -1770,11 +2302,13 @@ void database::_apply_block(const signed_block& next_block)
             }
         }
 
-        const witness_object& signing_witness = validate_block_header(skip, next_block);
+        const witness_object& signing_witness = validate_block_header(skip, next_block, prevalidated);
 
         _current_block_num = next_block_num;
         _current_trx_in_block = 0;
 
+        _async_indexer.begin_block(next_block_num, next_block.id(), next_block.timestamp);
+
         const auto& gprops = get_dynamic_global_properties();
         auto block_size = fc::raw::pack_size(next_block);
         FC_ASSERT(block_size <= gprops.maximum_block_size, "Block Size is too Big",
@@ -1793,48 +2327,89 @@ void database::_apply_block(const signed_block& next_block)
                   "Block produced by witness that is not running current hardfork",
                   ("witness", witness)("next_block.witness", next_block.witness)("hardfork_state", hardfork_state));
 
-        for (const auto& trx : next_block.transactions)
-        {
-            /* We do not need to push the undo state for each transaction
-             * because they either all apply and are valid or the
-             * entire block fails to apply.  We only need an "undo" state
-             * for transactions when validating broadcast transactions or
-             * when building a block.
-             */
-            apply_transaction(trx, skip);
-            ++_current_trx_in_block;
-        }
+        _block_timer.end_phase(block_timer::header);
+
+        detail::with_authority_cache(_authority_cache, [&]() {
+            std::vector<uint8_t> verified;
+            if (!(skip & (skip_transaction_signatures | skip_authority_check)))
+            {
+                verified = verify_block_authorities(next_block, prevalidated);
+            }
+
+            for (const auto& trx : next_block.transactions)
+            {
+                /* We do not need to push the undo state for each transaction
+                 * because they either all apply and are valid or the
+                 * entire block fails to apply.  We only need an "undo" state
+                 * for transactions when validating broadcast transactions or
+                 * when building a block.
+                 */
+                bool trx_verified = !verified.empty() && verified[_current_trx_in_block];
+                apply_transaction(trx, trx_verified ? skip | skip_transaction_signatures : skip,
+                                  find_signature_keys(prevalidated, _current_trx_in_block));
+                ++_current_trx_in_block;
+
+                // next transactions are verified against authorities updated by this one
+                for (const auto& name : mempool::get_authority_updates(trx))
+                {
+                    _authority_cache.invalidate(name);
+                }
+            }
+        });
+
+        _block_timer.end_phase(block_timer::transactions);
 
         update_global_dynamic_data(next_block);
         update_signing_witness(signing_witness, next_block);
 
+        _block_timer.end_phase(block_timer::global_properties);
+
         update_last_irreversible_block();
 
+        _block_timer.end_phase(block_timer::irreversible_block);
+
         create_block_summary(next_block);
-        clear_expired_transactions();
-        clear_expired_delegations();
+
+        _due_events.process(transaction_expiration, vesting_delegation_expiration, head_block_time());
+
+        _block_timer.end_phase(block_timer::expirations);
 
         // in dbs_database_witness_schedule.cpp
         update_witness_schedule();
 
+        _block_timer.end_phase(block_timer::witness_schedule);
+
         process_funds();
-        obtain_service<dbs_atomicswap>().check_contracts_expiration();
+
+        _block_timer.end_phase(block_timer::funds);
+
+        _due_events.process(atomicswap_contract_expiration, atomicswap_contract_expiration, head_block_time());
+
+        _block_timer.end_phase(block_timer::expirations);
 
         process_comment_cashout();
-        process_vesting_withdrawals();
 
-        account_recovery_processing();
-        expire_escrow_ratification();
-        process_decline_voting_rights();
+        _block_timer.end_phase(block_timer::comment_cashout);
 
-        this->obtain_service<dbs_proposal>().clear_expired_proposals();
+        _due_events.process(vesting_withdrawal, vesting_withdrawal, head_block_time());
+        _account_deltas.flush();
+
+        _block_timer.end_phase(block_timer::vesting_withdrawals);
+
+        _due_events.process(account_recovery_request_expiration, proposal_expiration, head_block_time());
+
+        _block_timer.end_phase(block_timer::expirations);
 
         process_hardforks();
 
+        _block_timer.end_phase(block_timer::hardforks);
+
         // notify observers that the block has been applied
         notify_applied_block(next_block);
 
         notify_changed_objects();
+
+        _block_timer.end_phase(block_timer::applied_block_handlers);
     } // FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
     FC_CAPTURE_LOG_AND_RETHROW((next_block.block_num()))
 }
@@ -1884,13 +2459,16 @@ void database::process_header_extensions(const signed_block& next_block)
     }
 }
 
-void database::apply_transaction(const signed_transaction& trx, uint32_t skip)
+void database::apply_transaction(const signed_transaction& trx,
+                                 uint32_t skip,
+                                 const fc::flat_set<public_key_type>* signature_keys)
 {
-    detail::with_skip_flags(*this, skip, [&]() { _apply_transaction(trx); });
+    graphene::utilities::trace_scope trace("apply_transaction", "chain", _current_trx_in_block);
+    detail::with_skip_flags(*this, skip, [&]() { _apply_transaction(trx, signature_keys); });
     notify_on_applied_transaction(trx);
 }
 
-void database::_apply_transaction(const signed_transaction& trx)
+void database::_apply_transaction(const signed_transaction& trx, const fc::flat_set<public_key_type>* signature_keys)
 {
     try
     {
@@ -1911,27 +2489,7 @@ void database::_apply_transaction(const signed_transaction& trx)
 
         if (!(skip & (skip_transaction_signatures | skip_authority_check)))
         {
-            auto get_active = [&](const std::string& name) {
-                return authority(get<account_authority_object, by_account>(name).active);
-            };
-            auto get_owner = [&](const std::string& name) {
-                return authority(get<account_authority_object, by_account>(name).owner);
-            };
-            auto get_posting = [&](const std::string& name) {
-                return authority(get<account_authority_object, by_account>(name).posting);
-            };
-
-            try
-            {
-                trx.verify_authority(get_chain_id(), get_active, get_owner, get_posting, SCORUM_MAX_SIG_CHECK_DEPTH);
-            }
-            catch (protocol::tx_missing_active_auth& e)
-            {
-                if (get_shared_db_merkle().find(head_block_num() + 1) == get_shared_db_merkle().end())
-                {
-                    throw e;
-                }
-            }
+            verify_authority(trx, signature_keys);
         }
 
         // Skip all manner of expiration and TaPoS checking if we're on block 1; It's impossible that the transaction is
@@ -1965,7 +2523,8 @@ void database::_apply_transaction(const signed_transaction& trx)
             create<transaction_object>([&](transaction_object& transaction) {
                 transaction.trx_id = trx_id;
                 transaction.expiration = trx.expiration;
-                fc::raw::pack(transaction.packed_trx, trx);
+                // transactions are applied before the block becomes the head block
+                transaction.block_num = head_block_num() + 1;
             });
         }
 
@@ -1990,12 +2549,30 @@ void database::_apply_transaction(const signed_transaction& trx)
 void database::apply_operation(const operation& op)
 {
     operation_notification note(op);
+
+    if (!_operation_profiler.enabled())
+    {
+        notify_pre_apply_operation(note);
+        _my->_evaluator_registry.get_evaluator(op).apply(op);
+        notify_post_apply_operation(note);
+        return;
+    }
+
+    using clock = operation_profiler::clock;
+
+    const auto start = clock::now();
     notify_pre_apply_operation(note);
+    const auto evaluate_start = clock::now();
     _my->_evaluator_registry.get_evaluator(op).apply(op);
+    const auto evaluate_end = clock::now();
     notify_post_apply_operation(note);
+
+    _operation_profiler.record(op, evaluate_start - start, evaluate_end - evaluate_start, clock::now() - evaluate_end);
 }
 
-const witness_object& database::validate_block_header(uint32_t skip, const signed_block& next_block) const
+const witness_object& database::validate_block_header(uint32_t skip,
+                                                      const signed_block& next_block,
+                                                      const prevalidated_block* prevalidated) const
 {
     try
     {
@@ -2008,7 +2585,14 @@ const witness_object& database::validate_block_header(uint32_t skip, const signe
 
         if (!(skip & skip_witness_signature))
         {
-            FC_ASSERT(next_block.validate_signee(witness.signing_key));
+            if (prevalidated != nullptr && prevalidated->signee.valid())
+            {
+                FC_ASSERT(*prevalidated->signee == witness.signing_key);
+            }
+            else
+            {
+                FC_ASSERT(next_block.validate_signee(witness.signing_key));
+            }
         }
 
         if (!(skip & skip_witness_schedule_check))
@@ -2181,6 +2765,8 @@ void database::update_last_irreversible_block()
 
             if (log_head_num < dpo.last_irreversible_block_num)
             {
+                graphene::utilities::trace_scope trace("block_log_append", "chain", dpo.last_irreversible_block_num);
+
                 while (log_head_num < dpo.last_irreversible_block_num)
                 {
                     std::shared_ptr<fork_item> block = _fork_db.fetch_block_on_main_branch_by_number(log_head_num + 1);
@@ -2198,47 +2784,163 @@ void database::update_last_irreversible_block()
     FC_CAPTURE_AND_RETHROW()
 }
 
-void database::clear_expired_transactions()
+authority database::get_authority(const account_name_type& name, authority_cache::authority_type type) const
+{
+    auto load = [&]() {
+        const auto& auth = get<account_authority_object, by_account>(name);
+        switch (type)
+        {
+        case authority_cache::owner:
+            return authority(auth.owner);
+        case authority_cache::posting:
+            return authority(auth.posting);
+        default:
+            return authority(auth.active);
+        }
+    };
+
+    // authority getters of sign_state return copies, the cached one is copied outside of the cache lock
+    return _authority_cache.enabled() ? *_authority_cache.get(name, type, load) : load();
+}
+
+void database::verify_authority(const signed_transaction& trx,
+                                const fc::flat_set<public_key_type>* signature_keys) const
 {
-    // Look for expired transactions in the deduplication list, and remove them.
-    // Transactions must have expired by at least two forking windows in order to be removed.
-    auto& transaction_idx = get_index<transaction_index>();
-    const auto& dedupe_index = transaction_idx.indices().get<by_expiration>();
-    while ((!dedupe_index.empty()) && (head_block_time() > dedupe_index.begin()->expiration))
+    auto get_active = [&](const std::string& name) { return get_authority(name, authority_cache::active); };
+    auto get_owner = [&](const std::string& name) { return get_authority(name, authority_cache::owner); };
+    auto get_posting = [&](const std::string& name) { return get_authority(name, authority_cache::posting); };
+
+    try
+    {
+        if (signature_keys != nullptr)
+        {
+            protocol::verify_authority(trx.operations, *signature_keys, get_active, get_owner, get_posting,
+                                       SCORUM_MAX_SIG_CHECK_DEPTH);
+        }
+        else
+        {
+            trx.verify_authority(get_chain_id(), get_active, get_owner, get_posting, SCORUM_MAX_SIG_CHECK_DEPTH);
+        }
+    }
+    catch (protocol::tx_missing_active_auth& e)
     {
-        remove(*dedupe_index.begin());
+        if (get_shared_db_merkle().find(head_block_num() + 1) == get_shared_db_merkle().end())
+        {
+            throw e;
+        }
     }
 }
 
-void database::clear_expired_delegations()
+namespace {
+
+// checks of fewer transactions are not worth starting threads for
+const size_t parallel_authority_check_min_transactions = 8;
+}
+
+std::vector<uint8_t> database::verify_block_authorities(const signed_block& b,
+                                                        const prevalidated_block* prevalidated) const
 {
-    auto now = head_block_time();
-    const auto& delegations_by_exp = get_index<vesting_delegation_expiration_index, by_expiration>();
-    auto itr = delegations_by_exp.begin();
-    while (itr != delegations_by_exp.end() && itr->expiration < now)
-    {
-        modify(get_account(itr->delegator),
-               [&](account_object& a) { a.delegated_vesting_shares -= itr->vesting_shares; });
+    const size_t count = b.transactions.size();
+
+    std::vector<uint8_t> verified(count, 0);
+    if (count < parallel_authority_check_min_transactions)
+        return verified;
+
+    // checks only read the state before the block, so they run in parallel
+    std::vector<fc::flat_set<account_name_type>> authority_accounts(count);
+    util::parallel_for(count, 0, [&](size_t i) {
+        try
+        {
+            verify_authority(b.transactions[i], find_signature_keys(prevalidated, i));
+            authority_accounts[i] = get_authority_accounts(b.transactions[i]);
+            verified[i] = 1;
+        }
+        catch (...)
+        {
+            // failed check is repeated on apply to report the error
+        }
+    });
 
-        push_virtual_operation(return_vesting_delegation_operation(itr->delegator, itr->vesting_shares));
+    // the result is kept only if no earlier transaction of the block changes authorities the check depends on
+    fc::flat_set<account_name_type> updated;
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (const auto& name : authority_accounts[i])
+        {
+            if (updated.find(name) != updated.end())
+            {
+                verified[i] = 0;
+                break;
+            }
+        }
 
-        remove(*itr);
-        itr = delegations_by_exp.begin();
+        auto trx_updated = mempool::get_authority_updates(b.transactions[i]);
+        updated.insert(trx_updated.begin(), trx_updated.end());
     }
+
+    return verified;
 }
 
-void database::adjust_balance(const account_object& a, const asset& delta)
+fc::flat_set<account_name_type> database::get_authority_accounts(const signed_transaction& trx) const
 {
-    modify(a, [&](account_object& acnt) {
-        switch (delta.symbol)
+    fc::flat_set<account_name_type> required_active;
+    fc::flat_set<account_name_type> required_owner;
+    fc::flat_set<account_name_type> required_posting;
+    std::vector<authority> other;
+    trx.get_required_authorities(required_active, required_owner, required_posting, other);
+
+    fc::flat_set<account_name_type> result;
+    std::vector<account_name_type> level;
+
+    auto add = [&](const account_name_type& name) {
+        if (result.insert(name).second)
+            level.push_back(name);
+    };
+
+    for (const auto& name : required_active)
+        add(name);
+    for (const auto& name : required_owner)
+        add(name);
+    for (const auto& name : required_posting)
+        add(name);
+    for (const auto& auth : other)
+        for (const auto& a : auth.account_auths)
+            add(a.first);
+
+    // signatures may be provided by accounts listed in authorities up to the same depth verify_authority() goes
+    for (uint32_t depth = 0; depth < SCORUM_MAX_SIG_CHECK_DEPTH && !level.empty(); ++depth)
+    {
+        std::vector<account_name_type> current;
+        current.swap(level);
+
+        for (const auto& name : current)
         {
-        case SCORUM_SYMBOL:
-            acnt.balance += delta;
-            break;
-        default:
-            FC_ASSERT(false, "invalid symbol");
+            const auto* auth = find<account_authority_object, by_account>(name);
+            if (auth == nullptr)
+                continue;
+
+            for (const auto& a : auth->owner.account_auths)
+                add(a.first);
+            for (const auto& a : auth->active.account_auths)
+                add(a.first);
+            for (const auto& a : auth->posting.account_auths)
+                add(a.first);
         }
-    });
+    }
+
+    return result;
+}
+
+void database::adjust_balance(const account_object& a, const asset& delta)
+{
+    switch (delta.symbol)
+    {
+    case SCORUM_SYMBOL:
+        obtain_service<dbs_account>().increase_balance(a, delta);
+        break;
+    default:
+        FC_ASSERT(false, "invalid symbol");
+    }
 }
 
 asset database::get_balance(const account_object& a, asset_symbol_type symbol) const
@@ -2348,11 +3050,36 @@ void database::apply_hardfork(uint32_t hardfork)
  * Verifies all supply invariants check out
  */
 void database::validate_invariants() const
+{
+    try
+    {
+        const auto& gpo = get_dynamic_global_properties();
+
+        asset total_supply = gpo.total_accounts_balance;
+
+        total_supply += gpo.total_escrow_balance;
+        total_supply += gpo.total_atomicswap_balance;
+        total_supply += gpo.total_budgets_balance;
+
+        total_supply += get_reward_fund().reward_balance;
+
+        total_supply += gpo.total_vesting_shares * gpo.get_vesting_share_price();
+
+        total_supply += obtain_service<dbs_reward>().get_pool().balance;
+        total_supply += obtain_service<dbs_registration_pool>().get_pool().balance;
+
+        FC_ASSERT(gpo.total_supply == total_supply, "",
+                  ("gpo.total_supply", gpo.total_supply)("total_supply", total_supply));
+    }
+    FC_CAPTURE_LOG_AND_RETHROW((head_block_num()));
+}
+
+void database::audit_invariants() const
 {
     try
     {
         const auto& account_idx = get_index<account_index>().indices().get<by_name>();
-        asset total_supply = asset(0, SCORUM_SYMBOL);
+        asset total_accounts_balance = asset(0, SCORUM_SYMBOL);
         asset total_vesting = asset(0, VESTS_SYMBOL);
         share_type total_vsf_votes = share_type(0);
 
@@ -2367,7 +3094,7 @@ void database::validate_invariants() const
 
         for (auto itr = account_idx.begin(); itr != account_idx.end(); ++itr)
         {
-            total_supply += itr->balance;
+            total_accounts_balance += itr->balance;
             total_vesting += itr->vesting_shares;
             total_vsf_votes += (itr->proxy == SCORUM_PROXY_TO_SELF_ACCOUNT
                                     ? itr->witness_vote_weight()
@@ -2376,15 +3103,23 @@ void database::validate_invariants() const
                                            : itr->vesting_shares.amount));
         }
 
+        FC_ASSERT(gpo.total_accounts_balance == total_accounts_balance, "",
+                  ("gpo.total_accounts_balance", gpo.total_accounts_balance)("total_accounts_balance",
+                                                                             total_accounts_balance));
+
         const auto& escrow_idx = get_index<escrow_index>().indices().get<by_id>();
+        asset total_escrow_balance = asset(0, SCORUM_SYMBOL);
 
         for (auto itr = escrow_idx.begin(); itr != escrow_idx.end(); ++itr)
         {
-            total_supply += itr->scorum_balance;
+            total_escrow_balance += itr->scorum_balance;
 
-            total_supply += itr->pending_fee;
+            total_escrow_balance += itr->pending_fee;
         }
 
+        FC_ASSERT(gpo.total_escrow_balance == total_escrow_balance, "",
+                  ("gpo.total_escrow_balance", gpo.total_escrow_balance)("total_escrow_balance", total_escrow_balance));
+
         fc::uint128_t total_rshares2;
 
         const auto& comment_idx = get_index<comment_index>().indices();
@@ -2398,30 +3133,39 @@ void database::validate_invariants() const
             }
         }
 
-        total_supply += get_reward_fund().reward_balance;
-
-        total_supply += gpo.total_vesting_shares * gpo.get_vesting_share_price();
-
-        total_supply += obtain_service<dbs_reward>().get_pool().balance;
+        asset total_budgets_balance = asset(0, SCORUM_SYMBOL);
+        asset budgets_per_block = asset(0, SCORUM_SYMBOL);
         for (const budget_object& budget : obtain_service<dbs_budget>().get_budgets())
         {
-            total_supply += budget.balance;
+            total_budgets_balance += budget.balance_at(head_block_num());
+            budgets_per_block += asset(budget.per_block, SCORUM_SYMBOL);
         }
-        total_supply += obtain_service<dbs_registration_pool>().get_pool().balance;
+
+        FC_ASSERT(gpo.total_budgets_balance == total_budgets_balance, "",
+                  ("gpo.total_budgets_balance", gpo.total_budgets_balance)("total_budgets_balance",
+                                                                           total_budgets_balance));
+        FC_ASSERT(gpo.budgets_per_block == budgets_per_block, "",
+                  ("gpo.budgets_per_block", gpo.budgets_per_block)("budgets_per_block", budgets_per_block));
 
         const auto& atomicswap_contract_idx = get_index<atomicswap_contract_index, by_id>();
+        asset total_atomicswap_balance = asset(0, SCORUM_SYMBOL);
 
         for (auto itr = atomicswap_contract_idx.begin(); itr != atomicswap_contract_idx.end(); ++itr)
         {
-            total_supply += itr->amount;
+            total_atomicswap_balance += itr->amount;
         }
 
-        FC_ASSERT(gpo.total_supply == total_supply, "",
-                  ("gpo.total_supply", gpo.total_supply)("total_supply", total_supply));
+        FC_ASSERT(gpo.total_atomicswap_balance == total_atomicswap_balance, "",
+                  ("gpo.total_atomicswap_balance", gpo.total_atomicswap_balance)("total_atomicswap_balance",
+                                                                                 total_atomicswap_balance));
+
         FC_ASSERT(gpo.total_vesting_shares == total_vesting, "",
                   ("gpo.total_vesting_shares", gpo.total_vesting_shares)("total_vesting", total_vesting));
         FC_ASSERT(gpo.total_vesting_shares.amount == total_vsf_votes, "",
                   ("total_vesting_shares", gpo.total_vesting_shares)("total_vsf_votes", total_vsf_votes));
+
+        // with running totals matching the objects the supply check covers the whole state
+        validate_invariants();
     }
     FC_CAPTURE_LOG_AND_RETHROW((head_block_num()));
 }
@@ -0,0 +1,46 @@
+#include <scorum/chain/due_event_scheduler.hpp>
+
+#include <fc/exception/exception.hpp>
+
+namespace scorum {
+namespace chain {
+
+void due_event_scheduler::set_handler(due_event_kind kind, next_due_type next_due, process_type process)
+{
+    FC_ASSERT(kind < due_event_kinds_count, "Invalid due event kind ${k}", ("k", (uint32_t)kind));
+
+    handler& h = _handlers[kind];
+    h.next_due = std::move(next_due);
+    h.process = std::move(process);
+}
+
+uint32_t due_event_scheduler::process(due_event_kind first, due_event_kind last, fc::time_point_sec now)
+{
+    FC_ASSERT(first <= last && last < due_event_kinds_count);
+
+    uint32_t total = 0;
+
+    for (uint32_t kind = first; kind <= last; ++kind)
+    {
+        handler& h = _handlers[kind];
+        FC_ASSERT(h.next_due && h.process, "No handler for due event kind ${k}", ("k", (due_event_kind)kind));
+
+        for (auto due = h.next_due(); due.valid() && *due <= now; due = h.next_due())
+        {
+            h.process();
+            ++h.processed;
+            ++total;
+        }
+    }
+
+    return total;
+}
+
+uint64_t due_event_scheduler::processed(due_event_kind kind) const
+{
+    FC_ASSERT(kind < due_event_kinds_count);
+    return _handlers[kind].processed;
+}
+
+} // namespace chain
+} // namespace scorum
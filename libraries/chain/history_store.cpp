@@ -0,0 +1,733 @@
+#include <scorum/chain/history_store.hpp>
+
+#include <fc/container/deque.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace scorum {
+namespace chain {
+
+namespace bip = boost::interprocess;
+
+namespace {
+
+struct transaction_record
+{
+    uint64_t prefix;
+    uint64_t position;
+};
+
+std::unique_ptr<bip::mapped_region> map_file(const fc::path& file, uint64_t size)
+{
+    if (size == 0)
+        return std::unique_ptr<bip::mapped_region>();
+
+    bip::file_mapping mapping(file.generic_string().c_str(), bip::read_only);
+    return std::unique_ptr<bip::mapped_region>(new bip::mapped_region(mapping, bip::read_only, 0, size));
+}
+
+void append_to_file(const fc::path& file, const char* data, size_t size)
+{
+    std::ofstream out;
+    out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    out.open(file.generic_string(), std::ios::binary | std::ios::app);
+    out.write(data, size);
+}
+
+// flush written data of a file or entries of a directory to the disk
+void sync_file(const fc::path& file)
+{
+    int fd = ::open(file.generic_string().c_str(), O_RDONLY);
+    FC_ASSERT(fd >= 0, "Could not open ${f} to sync: ${e}", ("f", file)("e", std::strerror(errno)));
+
+    int result = ::fsync(fd);
+    int error = errno;
+    ::close(fd);
+
+    FC_ASSERT(result == 0, "Could not sync ${f}: ${e}", ("f", file)("e", std::strerror(error)));
+}
+
+void check_file_size(const fc::path& file, uint64_t size)
+{
+    const uint64_t file_size = fc::exists(file) ? fc::file_size(file) : 0;
+    FC_ASSERT(file_size >= size, "History file ${f} has ${s} bytes, but ${n} bytes are committed",
+              ("f", file)("s", file_size)("n", size));
+}
+
+void truncate_file(const fc::path& file, uint64_t size)
+{
+    if (fc::exists(file) && fc::file_size(file) > size)
+        boost::filesystem::resize_file(file.generic_string(), size);
+}
+
+// write to a temporary file first, so a crash leaves either the old or the new file
+void replace_file(const fc::path& file, const std::vector<char>& data)
+{
+    fc::path tmp_file = file.generic_string() + ".tmp";
+    {
+        std::ofstream out;
+        out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        out.open(tmp_file.generic_string(), std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+    }
+    sync_file(tmp_file);
+    fc::rename(tmp_file, file);
+    sync_file(file.parent_path());
+}
+}
+
+history_store::history_store(uint64_t operations_per_segment, uint32_t commit_blocks)
+    : _operations_per_segment(operations_per_segment)
+    , _commit_blocks(commit_blocks)
+{
+    FC_ASSERT(_operations_per_segment > 0);
+    FC_ASSERT(_commit_blocks > 0);
+}
+
+history_store::~history_store()
+{
+}
+
+void history_store::open(const fc::path& dir)
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        FC_ASSERT(!_open && _window.empty(), "History store must be opened before operations are appended");
+
+        _dir = dir;
+        fc::create_directories(_dir / "accounts");
+
+        fc::path state_file = _dir / "state.json";
+        if (fc::exists(state_file))
+            _state = fc::json::from_file(state_file).as<history_store_state>();
+
+        check_files();
+        truncate_files();
+        load_transactions();
+        map_files();
+
+        _open = true;
+        _head_block_num = _state.committed_block_num;
+
+        fc::path window_file = _dir / "window.bin";
+        if (fc::exists(window_file))
+        {
+            std::vector<char> data(fc::file_size(window_file));
+            {
+                std::ifstream in;
+                in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+                in.open(window_file.generic_string(), std::ios::binary);
+                in.read(data.data(), data.size());
+            }
+
+            uint32_t head_block_num = 0;
+            std::deque<history_entry> window;
+
+            fc::datastream<const char*> ds(data.data(), data.size());
+            fc::raw::unpack(ds, head_block_num);
+            fc::raw::unpack(ds, window);
+
+            // the state could be saved after the window was
+            for (history_entry& e : window)
+            {
+                if (e.op.block > _state.committed_block_num)
+                    append_entry(std::move(e));
+            }
+
+            _head_block_num = std::max(_head_block_num, head_block_num);
+        }
+
+        ilog("Opened history store with ${n} operations up to block ${b}, head block ${h}",
+             ("n", _state.operations)("b", _state.committed_block_num)("h", _head_block_num));
+    }
+    FC_CAPTURE_AND_RETHROW((dir))
+}
+
+void history_store::append(const indexed_operation& op, const std::vector<account_name_type>& accounts)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    FC_ASSERT(op.block > _state.committed_block_num, "Block ${b} is already committed", ("b", op.block));
+    FC_ASSERT(_window.empty() || _window.back().op.block <= op.block, "Operations must be appended in order",
+              ("block", op.block)("last", _window.back().op.block));
+
+    history_entry e;
+    e.op = op;
+    e.accounts = accounts;
+    append_entry(std::move(e));
+}
+
+void history_store::append_entry(history_entry&& e)
+{
+    const uint64_t position = _state.operations + _window.size();
+
+    for (const account_name_type& account : e.accounts)
+    {
+        _account_operations[account].push_back(position);
+    }
+
+    if (e.op.trx_id != transaction_id_type())
+        _transactions.insert(std::make_pair(e.op.trx_id, position));
+
+    _head_block_num = std::max(_head_block_num, e.op.block);
+
+    _window.push_back(std::move(e));
+}
+
+void history_store::set_head_block_num(uint32_t block_num)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _head_block_num = std::max(block_num, _state.committed_block_num);
+}
+
+void history_store::pop_blocks(uint32_t block_num)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    while (!_window.empty() && _window.back().op.block > block_num)
+    {
+        const history_entry& e = _window.back();
+        const uint64_t position = _state.operations + _window.size() - 1;
+
+        for (const account_name_type& account : e.accounts)
+        {
+            auto itr = _account_operations.find(account);
+            itr->second.pop_back();
+            if (itr->second.empty())
+                _account_operations.erase(itr);
+        }
+
+        auto itr = _transactions.find(e.op.trx_id);
+        if (itr != _transactions.end() && itr->second == position)
+            _transactions.erase(itr);
+
+        _window.pop_back();
+    }
+
+    _head_block_num = std::max(std::min(_head_block_num, block_num), _state.committed_block_num);
+}
+
+void history_store::commit(uint32_t block_num)
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _irreversible_block_num = std::max(_irreversible_block_num, block_num);
+
+        // every write syncs the files, so irreversible blocks are written in batches
+        const uint32_t committed_block_num = std::min(_irreversible_block_num, _head_block_num);
+        if (committed_block_num >= (uint64_t)_state.committed_block_num + _commit_blocks)
+            write_files();
+    }
+    FC_CAPTURE_AND_RETHROW((block_num))
+}
+
+void history_store::flush()
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        write_files();
+    }
+    FC_CAPTURE_AND_RETHROW()
+}
+
+void history_store::write_files()
+{
+    if (!_open || _failed)
+        return;
+
+    const uint32_t committed_block_num = std::min(_irreversible_block_num, _head_block_num);
+    if (committed_block_num > _state.committed_block_num)
+    {
+        size_t count = 0;
+        while (count < _window.size() && _window[count].op.block <= committed_block_num)
+        {
+            ++count;
+        }
+
+        write_operations(count);
+
+        _state.committed_block_num = committed_block_num;
+        save_state();
+    }
+
+    write_window();
+}
+
+void history_store::write_operations(size_t count)
+{
+    if (count == 0)
+        return;
+
+    const uint64_t first_position = _state.operations;
+
+    std::map<account_name_type, std::vector<uint64_t>> account_positions;
+    std::vector<transaction_record> transactions;
+
+    // appended files are synced before the state which commits their records is saved
+    std::set<std::string> appended_files;
+    appended_files.insert((_dir / "operations.index").generic_string());
+
+    try
+    {
+        std::ofstream index_out;
+        index_out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        index_out.open((_dir / "operations.index").generic_string(), std::ios::binary | std::ios::app);
+
+        std::ofstream segment_out;
+        segment_out.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+
+        // operations of a segment follow the last committed one
+        uint64_t offset = 0;
+        if (first_position % _operations_per_segment != 0)
+        {
+            operation_record last = get_record(first_position - 1);
+            offset = last.offset + last.size;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const history_entry& e = _window[i];
+            const uint64_t position = first_position + i;
+
+            if (position % _operations_per_segment == 0 || !segment_out.is_open())
+            {
+                if (segment_out.is_open())
+                    segment_out.close();
+                if (position % _operations_per_segment == 0)
+                    offset = 0;
+
+                fc::path file = segment_file(position / _operations_per_segment);
+                segment_out.open(file.generic_string(), std::ios::binary | std::ios::app);
+                appended_files.insert(file.generic_string());
+            }
+
+            std::vector<char> data = fc::raw::pack(e.op);
+            segment_out.write(data.data(), data.size());
+
+            operation_record record;
+            record.offset = offset;
+            record.block = e.op.block;
+            record.size = (uint32_t)data.size();
+            index_out.write((const char*)&record, sizeof(record));
+
+            offset += data.size();
+
+            for (const account_name_type& account : e.accounts)
+            {
+                account_positions[account].push_back(position);
+            }
+
+            auto itr = _transactions.find(e.op.trx_id);
+            if (itr != _transactions.end() && itr->second == position)
+            {
+                transaction_record trx;
+                trx.prefix = get_prefix(e.op.trx_id);
+                trx.position = position;
+                transactions.push_back(trx);
+            }
+        }
+
+        index_out.close();
+        if (segment_out.is_open())
+            segment_out.close();
+
+        for (const auto& item : account_positions)
+        {
+            fc::path file = account_file(item.first);
+            append_to_file(file, (const char*)item.second.data(), item.second.size() * sizeof(uint64_t));
+            appended_files.insert(file.generic_string());
+        }
+
+        if (!transactions.empty())
+        {
+            append_to_file(_dir / "transactions.index", (const char*)transactions.data(),
+                           transactions.size() * sizeof(transaction_record));
+            appended_files.insert((_dir / "transactions.index").generic_string());
+        }
+
+        for (const std::string& file : appended_files)
+        {
+            sync_file(fc::path(file));
+        }
+
+        // entries of created files
+        sync_file(_dir);
+        sync_file(_dir / "accounts");
+    }
+    catch (...)
+    {
+        // records of the failed write would shift the records of the next one
+        try
+        {
+            truncate_files();
+        }
+        catch (const fc::exception& e)
+        {
+            _failed = true;
+            elog("History store stops writing, its files could not be truncated: ${e}", ("e", e.to_detail_string()));
+        }
+        catch (const std::exception& e)
+        {
+            _failed = true;
+            elog("History store stops writing, its files could not be truncated: ${e}", ("e", e.what()));
+        }
+        throw;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const history_entry& e = _window.front();
+
+        for (const account_name_type& account : e.accounts)
+        {
+            auto itr = _account_operations.find(account);
+            itr->second.pop_front();
+            if (itr->second.empty())
+                _account_operations.erase(itr);
+        }
+
+        auto itr = _transactions.find(e.op.trx_id);
+        if (itr != _transactions.end() && itr->second == first_position + i)
+            _transactions.erase(itr);
+
+        _window.pop_front();
+    }
+
+    for (const transaction_record& trx : transactions)
+    {
+        _committed_transactions.insert(std::make_pair(trx.prefix, trx.position));
+    }
+
+    _state.operations += count;
+    _state.transactions += transactions.size();
+
+    // segments which were appended to are mapped again when read
+    for (uint64_t segment = first_position / _operations_per_segment; segment < _segment_regions.size(); ++segment)
+    {
+        _segment_regions[segment].reset();
+    }
+
+    map_files();
+}
+
+void history_store::write_window() const
+{
+    std::vector<char> data(fc::raw::pack_size(_head_block_num) + fc::raw::pack_size(_window));
+
+    fc::datastream<char*> ds(data.data(), data.size());
+    fc::raw::pack(ds, _head_block_num);
+    fc::raw::pack(ds, _window);
+
+    replace_file(_dir / "window.bin", data);
+}
+
+void history_store::save_state() const
+{
+    std::string json = fc::json::to_pretty_string(_state);
+    replace_file(_dir / "state.json", std::vector<char>(json.begin(), json.end()));
+}
+
+void history_store::check_files() const
+{
+    check_file_size(_dir / "operations.index", _state.operations * sizeof(operation_record));
+    check_file_size(_dir / "transactions.index", _state.transactions * sizeof(transaction_record));
+
+    if (_state.operations == 0)
+        return;
+
+    std::ifstream in;
+    in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    in.open((_dir / "operations.index").generic_string(), std::ios::binary);
+
+    // the last committed record of every segment has to be in it
+    for (uint64_t segment = 0; segment * _operations_per_segment < _state.operations; ++segment)
+    {
+        const uint64_t last_position = std::min(_state.operations, (segment + 1) * _operations_per_segment) - 1;
+
+        operation_record last;
+        in.seekg(last_position * sizeof(operation_record));
+        in.read((char*)&last, sizeof(last));
+
+        check_file_size(segment_file(segment), last.offset + last.size);
+    }
+}
+
+void history_store::truncate_files()
+{
+    // records written after the state was saved are not committed
+    truncate_file(_dir / "operations.index", _state.operations * sizeof(operation_record));
+    truncate_file(_dir / "transactions.index", _state.transactions * sizeof(transaction_record));
+
+    const uint64_t last_segment = _state.operations / _operations_per_segment;
+
+    uint64_t last_segment_size = 0;
+    if (_state.operations % _operations_per_segment != 0)
+    {
+        operation_record last;
+
+        std::ifstream in;
+        in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        in.open((_dir / "operations.index").generic_string(), std::ios::binary);
+        in.seekg((_state.operations - 1) * sizeof(operation_record));
+        in.read((char*)&last, sizeof(last));
+
+        last_segment_size = last.offset + last.size;
+    }
+
+    truncate_file(segment_file(last_segment), last_segment_size);
+    for (uint64_t segment = last_segment + 1; fc::exists(segment_file(segment)); ++segment)
+    {
+        fc::remove(segment_file(segment));
+    }
+
+    for (boost::filesystem::directory_iterator itr((_dir / "accounts").generic_string()), end; itr != end; ++itr)
+    {
+        if (!boost::filesystem::is_regular_file(itr->status()))
+            continue;
+
+        const std::string file = itr->path().generic_string();
+        const uint64_t file_size = boost::filesystem::file_size(file);
+
+        uint64_t count = file_size / sizeof(uint64_t);
+        {
+            std::ifstream in;
+            in.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+            in.open(file, std::ios::binary);
+
+            while (count > 0)
+            {
+                uint64_t position = 0;
+                in.seekg((count - 1) * sizeof(uint64_t));
+                in.read((char*)&position, sizeof(position));
+
+                if (position < _state.operations)
+                    break;
+                --count;
+            }
+        }
+
+        if (count * sizeof(uint64_t) != file_size)
+            boost::filesystem::resize_file(file, count * sizeof(uint64_t));
+    }
+}
+
+void history_store::load_transactions()
+{
+    _committed_transactions.clear();
+    _committed_transactions.reserve(_state.transactions);
+
+    if (_state.transactions == 0)
+        return;
+
+    auto region = map_file(_dir / "transactions.index", _state.transactions * sizeof(transaction_record));
+    const char* data = (const char*)region->get_address();
+
+    for (uint64_t i = 0; i < _state.transactions; ++i)
+    {
+        transaction_record trx;
+        std::memcpy(&trx, data + i * sizeof(transaction_record), sizeof(trx));
+        _committed_transactions.insert(std::make_pair(trx.prefix, trx.position));
+    }
+}
+
+void history_store::map_files()
+{
+    _index_region = map_file(_dir / "operations.index", _state.operations * sizeof(operation_record));
+}
+
+uint32_t history_store::head_block_num() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _head_block_num;
+}
+
+uint32_t history_store::committed_block_num() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _state.committed_block_num;
+}
+
+history_store::operation_record history_store::get_record(uint64_t position) const
+{
+    operation_record record;
+    std::memcpy(&record, (const char*)_index_region->get_address() + position * sizeof(operation_record),
+                sizeof(record));
+    return record;
+}
+
+indexed_operation history_store::get_operation(uint64_t position) const
+{
+    if (position >= _state.operations)
+        return _window[position - _state.operations].op;
+
+    const operation_record record = get_record(position);
+    const uint64_t segment = position / _operations_per_segment;
+
+    if (_segment_regions.size() <= segment)
+        _segment_regions.resize(segment + 1);
+
+    region_ptr& region = _segment_regions[segment];
+    if (!region || region->get_size() < record.offset + record.size)
+    {
+        fc::path file = segment_file(segment);
+        region = map_file(file, fc::file_size(file));
+    }
+
+    return fc::raw::unpack<indexed_operation>((const char*)region->get_address() + record.offset, record.size);
+}
+
+uint64_t history_store::get_account_operations(const account_name_type& account) const
+{
+    if (!_open)
+        return 0;
+
+    fc::path file = account_file(account);
+    return fc::exists(file) ? fc::file_size(file) / sizeof(uint64_t) : 0;
+}
+
+std::map<uint32_t, indexed_operation>
+history_store::get_account_history(const account_name_type& account, uint64_t from, uint32_t limit) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::map<uint32_t, indexed_operation> result;
+
+    const uint64_t committed = get_account_operations(account);
+
+    auto itr = _account_operations.find(account);
+    const uint64_t total = committed + (itr != _account_operations.end() ? itr->second.size() : 0);
+    if (total == 0)
+        return result;
+
+    const uint64_t last = std::min<uint64_t>(from, total - 1);
+    const uint64_t first = last > limit ? last - limit : 0;
+
+    std::unique_ptr<bip::mapped_region> region;
+    if (first < committed)
+        region = map_file(account_file(account), committed * sizeof(uint64_t));
+
+    for (uint64_t sequence = first; sequence <= last; ++sequence)
+    {
+        uint64_t position = 0;
+        if (sequence < committed)
+            std::memcpy(&position, (const char*)region->get_address() + sequence * sizeof(uint64_t),
+                        sizeof(position));
+        else
+            position = itr->second[sequence - committed];
+
+        result[(uint32_t)sequence] = get_operation(position);
+    }
+
+    return result;
+}
+
+std::vector<indexed_operation> history_store::get_ops_in_block(uint32_t block_num) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<indexed_operation> result;
+
+    if (block_num <= _state.committed_block_num)
+    {
+        // records are ordered by block
+        uint64_t first = 0;
+        uint64_t count = _state.operations;
+        while (count > 0)
+        {
+            const uint64_t step = count / 2;
+            if (get_record(first + step).block < block_num)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        for (uint64_t position = first; position < _state.operations && get_record(position).block == block_num;
+             ++position)
+        {
+            result.push_back(get_operation(position));
+        }
+    }
+
+    auto itr = std::lower_bound(_window.begin(), _window.end(), block_num,
+                                [](const history_entry& e, uint32_t num) { return e.op.block < num; });
+
+    for (; itr != _window.end() && itr->op.block == block_num; ++itr)
+    {
+        result.push_back(itr->op);
+    }
+
+    return result;
+}
+
+fc::optional<indexed_operation> history_store::find_transaction(const transaction_id_type& trx_id) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    fc::optional<indexed_operation> result;
+
+    auto itr = _transactions.find(trx_id);
+    if (itr != _transactions.end())
+    {
+        result = _window[itr->second - _state.operations].op;
+        return result;
+    }
+
+    auto range = _committed_transactions.equal_range(get_prefix(trx_id));
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        indexed_operation op = get_operation(it->second);
+        if (op.trx_id == trx_id)
+        {
+            result = op;
+            break;
+        }
+    }
+
+    return result;
+}
+
+fc::path history_store::segment_file(uint64_t segment) const
+{
+    std::ostringstream name;
+    name << "operations." << std::setw(6) << std::setfill('0') << segment << ".log";
+    return _dir / name.str();
+}
+
+fc::path history_store::account_file(const account_name_type& account) const
+{
+    return _dir / "accounts" / (std::string(account) + ".index");
+}
+
+uint64_t history_store::get_prefix(const transaction_id_type& trx_id)
+{
+    return ((uint64_t)trx_id._hash[0] << 32) | trx_id._hash[1];
+}
+
+} // namespace chain
+} // namespace scorum
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <scorum/chain/schema/scorum_object_types.hpp>
+
+#include <scorum/protocol/asset.hpp>
+
+#include <map>
+
+namespace scorum {
+namespace chain {
+
+class database;
+class account_object;
+
+using scorum::protocol::asset;
+
+/**
+ *  Accumulates balance and vesting changes of accounts during a maintenance phase (reward payouts,
+ *  vesting withdrawals) and applies them with one modify per touched account.
+ *
+ *  Vesting is created at the fixed vesting share price, so amounts returned to the caller (and
+ *  reported in virtual operations) are the same as if they were applied immediately. Witness votes
+ *  are adjusted once per account with the total vesting delta, which leads to the same witness state
+ *  because the virtual schedule time does not change within a phase.
+ *
+ *  Accumulated changes are not visible through account objects until flush, the buffer must only be
+ *  used where paid accounts are not read back before the end of the phase.
+ */
+class account_delta_buffer
+{
+public:
+    explicit account_delta_buffer(database& db);
+
+    void increase_balance(const account_object& account, const asset& scorums);
+
+    /**
+     * Convert SCR to vesting shares of the account.
+     * @return created vesting shares
+     */
+    asset create_vesting(const account_object& account, const asset& scorums);
+
+    /**
+     * Move existing vesting shares to the account, total vesting shares are not changed.
+     */
+    void increase_vesting_shares(const account_object& account, const asset& vesting);
+
+    void increase_curation_rewards(const account_object& account, const share_type& amount);
+    void increase_posting_rewards(const account_object& account, const share_type& amount);
+
+    /**
+     * Apply accumulated changes and clear the buffer.
+     */
+    void flush();
+
+    /**
+     * Apply accumulated changes of one account, to be called before the account is read.
+     */
+    void flush(const account_object& account);
+
+    /**
+     * Drop accumulated changes without applying them.
+     */
+    void clear()
+    {
+        _deltas.clear();
+    }
+
+    bool empty() const
+    {
+        return _deltas.empty();
+    }
+
+private:
+    struct account_delta
+    {
+        share_type balance = 0;
+        share_type vesting_shares = 0;
+        share_type created_vesting_shares = 0;
+        share_type curation_rewards = 0;
+        share_type posting_rewards = 0;
+        bool vested = false;
+    };
+
+    void _apply_totals(const share_type& balance, const share_type& created_vesting_shares);
+    void _apply(const account_object& account, const account_delta& delta);
+
+    database& _db;
+
+    // ordered by id to keep the order of writes deterministic
+    std::map<account_id_type, account_delta> _deltas;
+};
+
+} // namespace chain
+} // namespace scorum
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <scorum/protocol/operations.hpp>
+
+#include <scorum/chain/operation_notification.hpp>
+
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace scorum {
+namespace chain {
+
+struct indexed_operation
+{
+    transaction_id_type trx_id;
+    uint32_t block = 0;
+    uint32_t trx_in_block = 0;
+    uint16_t op_in_trx = 0;
+    uint64_t virtual_op = 0;
+    fc::time_point_sec timestamp;
+    operation op;
+};
+
+struct indexed_block
+{
+    uint32_t block_num = 0;
+    block_id_type block_id;
+    fc::time_point_sec timestamp;
+    uint32_t last_irreversible_block_num = 0;
+
+    /// operations in order of application including virtual ones
+    std::vector<indexed_operation> operations;
+};
+
+struct async_indexer_stats
+{
+    /// last block applied to or popped from the chain
+    uint32_t head_block_num = 0;
+
+    /// watermark: consumers have processed all blocks up to this one
+    uint32_t indexed_block_num = 0;
+
+    uint32_t pending_blocks = 0;
+    uint64_t indexed_blocks = 0;
+    uint64_t rollbacks = 0;
+};
+
+/**
+ *  Ordered stream of operations of applied blocks consumed on a separate thread, so non-consensus indexes can be
+ *  built without holding the database write lock.
+ *
+ *  The database collects operations while a block is applied and queues the block when it is applied. Popped
+ *  blocks are dropped from the queue if they have not been processed yet, otherwise consumers are asked to roll
+ *  back to the new head block. Consumers must not access the database, they keep their data in their own stores.
+ *  Operations are collected only if a consumer is registered.
+ *
+ *  Applying blocks waits if consumers are max_pending_blocks behind, e.g. while the chain is replayed.
+ */
+class async_indexer
+{
+public:
+    using block_handler = std::function<void(const indexed_block&)>;
+
+    /// remove data of blocks above the given one
+    using rollback_handler = std::function<void(uint32_t block_num)>;
+
+    static const uint32_t default_max_pending_blocks = 1000;
+
+    explicit async_indexer(uint32_t max_pending_blocks = default_max_pending_blocks);
+    ~async_indexer();
+
+    /**
+     * Consumers are added before blocks are applied and are called in order of registration.
+     */
+    void add_consumer(const std::string& name, block_handler on_block, rollback_handler on_rollback);
+
+    bool has_consumers() const
+    {
+        return !_consumers.empty();
+    }
+
+    /// @{ called by the database on the thread applying blocks
+    void begin_block(uint32_t block_num, const block_id_type& block_id, fc::time_point_sec timestamp);
+
+    bool is_collecting() const
+    {
+        return _collecting;
+    }
+
+    void add_operation(const operation_notification& note, fc::time_point_sec timestamp);
+    void end_block(uint32_t last_irreversible_block_num);
+    void abort_block();
+    void pop_block(uint32_t head_block_num);
+    /// @}
+
+    /**
+     * Wait until consumers have processed all queued blocks.
+     */
+    void wait();
+
+    /**
+     * Process queued blocks and stop the consumer thread.
+     */
+    void stop();
+
+    uint32_t get_indexed_block_num() const
+    {
+        return _indexed_block_num.load(std::memory_order_acquire);
+    }
+
+    async_indexer_stats get_stats() const;
+
+private:
+    struct consumer
+    {
+        std::string name;
+        block_handler on_block;
+        rollback_handler on_rollback;
+    };
+
+    struct task
+    {
+        bool rollback = false;
+
+        /// block number to roll back to for rollback tasks
+        uint32_t block_num = 0;
+        indexed_block block;
+    };
+
+    void push(task&& t, std::unique_lock<std::mutex>& lock);
+    void run();
+    void process(const task& t);
+
+    const uint32_t _max_pending_blocks;
+    std::vector<consumer> _consumers;
+
+    bool _collecting = false;
+    indexed_block _current;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _queue_cv;
+    std::condition_variable _done_cv;
+    std::deque<task> _queue;
+
+    bool _processing = false;
+    bool _stopping = false;
+    std::thread _thread;
+
+    uint32_t _head_block_num = 0;
+    std::atomic<uint32_t> _indexed_block_num{ 0 };
+    uint64_t _indexed_blocks = 0;
+    uint64_t _rollbacks = 0;
+};
+
+} // namespace chain
+} // namespace scorum
+
+// clang-format off
+FC_REFLECT(scorum::chain::indexed_operation,
+           (trx_id)
+           (block)
+           (trx_in_block)
+           (op_in_trx)
+           (virtual_op)
+           (timestamp)
+           (op))
+
+FC_REFLECT(scorum::chain::async_indexer_stats,
+           (head_block_num)
+           (indexed_block_num)
+           (pending_blocks)
+           (indexed_blocks)
+           (rollbacks))
+// clang-format on
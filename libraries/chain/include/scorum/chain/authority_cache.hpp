@@ -0,0 +1,66 @@
+#pragma once
+
+#include <scorum/protocol/authority.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace scorum {
+namespace chain {
+
+using scorum::protocol::account_name_type;
+using scorum::protocol::authority;
+
+/**
+ *  Authorities of accounts converted from shared memory objects, kept while transactions of a block are verified.
+ *
+ *  Authorities of popular accounts (applications posting on behalf of users) are resolved by many transactions
+ *  of a block, the cache converts each of them once. Entries of accounts updated by a transaction have to be
+ *  invalidated before the next transaction is verified. Lookups can be done from several threads.
+ */
+class authority_cache
+{
+public:
+    enum authority_type : uint8_t
+    {
+        active = 0,
+        owner,
+        posting
+    };
+
+    using loader_type = std::function<authority()>;
+    using authority_ptr = std::shared_ptr<const authority>;
+
+    /**
+     * Return cached authority, it is loaded if it is not cached. Cached authorities are shared, so a lookup does
+     * not copy them under the lock and they stay valid after invalidation.
+     */
+    authority_ptr get(const account_name_type& name, authority_type type, const loader_type& load);
+
+    void invalidate(const account_name_type& name);
+
+    /**
+     * Start caching with empty cache.
+     */
+    void enable();
+
+    /**
+     * Stop caching and drop cached authorities.
+     */
+    void disable();
+
+    bool enabled() const
+    {
+        return _enabled;
+    }
+
+private:
+    std::mutex _mutex;
+    std::map<std::pair<account_name_type, authority_type>, authority_ptr> _authorities;
+    bool _enabled = false;
+};
+
+} // namespace chain
+} // namespace scorum
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <scorum/protocol/block.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+#include <memory>
+#include <mutex>
+
+namespace scorum {
+namespace chain {
+
+using scorum::protocol::signed_block;
+using scorum::protocol::block_id_type;
+
+struct block_cache_stats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint32_t size = 0;
+    uint32_t capacity = 0;
+};
+
+/**
+ *  Bounded LRU cache of decoded blocks that are part of the current main chain.
+ *
+ *  Blocks are stored as shared immutable objects and can be looked up either by number or by id.
+ *  The database fills the cache when a block is applied or read from the block log, and
+ *  invalidates it when a block is popped, so a cached block number always maps to the block
+ *  currently applied at that height.
+ *
+ *  All methods are thread safe, the cache is accessed by API threads under the database read lock.
+ */
+class block_cache
+{
+public:
+    using block_ptr = std::shared_ptr<const signed_block>;
+
+    static const uint32_t default_capacity = 2048;
+
+    explicit block_cache(uint32_t capacity = default_capacity);
+
+    /**
+     * Change the maximum number of blocks held, zero disables the cache.
+     */
+    void set_capacity(uint32_t capacity);
+
+    void insert(const signed_block& b);
+    void insert(const block_ptr& b);
+
+    block_ptr fetch_by_number(uint32_t block_num) const;
+    block_ptr fetch_by_id(const block_id_type& id) const;
+
+    /**
+     * Drop the block with given id (if present).
+     */
+    void remove(const block_id_type& id);
+    void clear();
+
+    block_cache_stats get_stats() const;
+
+private:
+    struct item
+    {
+        uint32_t num;
+        block_id_type id;
+        block_ptr data;
+    };
+
+    struct by_num;
+    struct by_id;
+
+    // clang-format off
+    using item_index_type = boost::multi_index_container<item,
+                            boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
+                                                           boost::multi_index::hashed_unique<boost::multi_index::tag<by_num>,
+                                                                                             boost::multi_index::member<item, uint32_t, &item::num>>,
+                                                           boost::multi_index::hashed_unique<boost::multi_index::tag<by_id>,
+                                                                                             boost::multi_index::member<item, block_id_type, &item::id>,
+                                                                                             std::hash<fc::ripemd160>>>>;
+    // clang-format on
+
+    template <typename Iterator> block_ptr _touch(Iterator it) const;
+
+    /**
+     * Move the block to the front if it is cached, a block with the same number and another id is dropped.
+     * @return true if the block is cached
+     */
+    bool _relocate(uint32_t num, const block_id_type& id);
+
+    void _shrink_to(uint32_t size);
+
+    mutable std::mutex _mutex;
+    mutable item_index_type _items;
+    mutable uint64_t _hits = 0;
+    mutable uint64_t _misses = 0;
+    uint32_t _capacity;
+};
+
+} // namespace chain
+} // namespace scorum
+
+FC_REFLECT(scorum::chain::block_cache_stats, (hits)(misses)(size)(capacity))
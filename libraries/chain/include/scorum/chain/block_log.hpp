@@ -11,6 +11,50 @@ namespace detail {
 class block_log_impl;
 }
 
+/**
+ * Decoded entry of the block header index, everything but the signature and the header extensions.
+ */
+struct block_header_record
+{
+    block_header_record() = default;
+    explicit block_header_record(const signed_block& b);
+
+    uint32_t block_num() const
+    {
+        return block_header::num_from_id(id);
+    }
+
+    block_id_type id;
+    block_id_type previous;
+    fc::time_point_sec timestamp;
+    std::string witness;
+    checksum_type transaction_merkle_root;
+    uint32_t transaction_count = 0;
+    bool has_extensions = false;
+};
+
+struct block_log_segment_info
+{
+    uint32_t first_block_num = 1;
+    std::string file;
+};
+
+struct block_log_manifest
+{
+    uint32_t segment_blocks = 0;
+    std::vector<block_log_segment_info> segments;
+};
+
+struct block_log_verify_result
+{
+    uint32_t first_block_num = 0;
+    uint32_t last_block_num = 0;
+    uint32_t verified_blocks = 0;
+
+    /// first problem found in every failed range of blocks
+    std::vector<std::string> errors;
+};
+
 /* The block log is an external append only log of the blocks. Blocks should only be written
  * to the log after they irreverisble as the log is append only. The log is a doubly linked
  * list of blocks. There is a secondary index file of only block positions that enables O(1)
@@ -32,8 +76,20 @@ class block_log_impl;
  * Blocks can be accessed at random via block number through the index file. Seek to 8 * (block_num - 1)
  * to find the position of the block in the main file.
  *
- * The main file is the only file that needs to persist. The index file can be reconstructed during a
- * linear scan of the main file.
+ * The header index file stores a fixed width record per block (id, previous, timestamp, witness,
+ * transaction merkle root and transaction count), so header, id and time queries do not need to
+ * deserialize blocks. Seek to header_record_size * (block_num - 1) to read the record of a block.
+ * Timestamps grow monotonically, so a time range is found with a binary search over the records.
+ *
+ * The log can be split into segments of a fixed number of blocks. Every segment is a block log of
+ * its own (with own index files and positions relative to the segment file) and the segments are
+ * listed in a manifest file next to the log. The segment starting with block 1 is stored in the
+ * original file, so an unsegmented log is a log with a single segment. Index offsets of a segment are
+ * counted from its first block instead of block 1. Whole segments of old blocks can be removed by pruning.
+ *
+ * The main files are the only files that need to persist. The index files can be reconstructed from the main
+ * file: the position index by a serial walk over the back pointers stored after every block, the header index by
+ * decoding ranges of blocks in parallel. Segments are reconstructed in parallel.
  */
 
 class block_log
@@ -42,28 +98,70 @@ public:
     block_log();
     ~block_log();
 
-    void open(const fc::path& file);
+    /**
+     * Open the log, a new segment is started every segment_blocks blocks, zero keeps appending to the last segment.
+     */
+    void open(const fc::path& file, uint32_t segment_blocks = 0);
     void close();
     bool is_open() const;
 
     uint64_t append(const signed_block& b);
     void flush();
-    std::pair<signed_block, uint64_t> read_block(uint64_t file_pos) const;
     optional<signed_block> read_block_by_num(uint32_t block_num) const;
 
     /**
-     * Return offset of block in file, or block_log::npos if it does not exist.
+     * Return offset of block in its segment file, or block_log::npos if it does not exist.
      */
     uint64_t get_block_pos(uint32_t block_num) const;
     signed_block read_head() const;
     const optional<signed_block>& head() const;
 
+    /**
+     * Return number of the first block kept in the log, it is greater than 1 if the log was pruned.
+     */
+    uint32_t first_block_num() const;
+
+    /**
+     * Remove segments that contain only blocks up to up_to_block_num, the last segment is never removed.
+     * @return number of removed blocks
+     */
+    uint32_t prune(uint32_t up_to_block_num);
+
+    optional<block_header_record> read_header_record_by_num(uint32_t block_num) const;
+
+    /**
+     * Return header of block, the block itself is read only if the header has extensions.
+     */
+    optional<block_header> read_header_by_num(uint32_t block_num) const;
+
+    /**
+     * Return up to limit header records of blocks with timestamp in [start, end).
+     */
+    std::vector<block_header_record>
+    read_header_records_by_time(fc::time_point_sec start, fc::time_point_sec end, uint32_t limit) const;
+
+    /**
+     * Check block numbers, ids against the header index, previous links and transaction merkle roots
+     * of all blocks using given number of threads (zero means all cores).
+     */
+    block_log_verify_result verify(uint32_t threads = 0) const;
+
+    /**
+     * Remove all files of the log (segments, indexes and manifest).
+     */
+    static void remove_files(const fc::path& file);
+
     static const uint64_t npos = std::numeric_limits<uint64_t>::max();
+    static const uint32_t header_record_size = 88;
 
 private:
-    void construct_index();
-
     std::unique_ptr<detail::block_log_impl> my;
 };
 }
 }
+
+FC_REFLECT(scorum::chain::block_header_record,
+           (id)(previous)(timestamp)(witness)(transaction_merkle_root)(transaction_count)(has_extensions))
+FC_REFLECT(scorum::chain::block_log_segment_info, (first_block_num)(file))
+FC_REFLECT(scorum::chain::block_log_manifest, (segment_blocks)(segments))
+FC_REFLECT(scorum::chain::block_log_verify_result, (first_block_num)(last_block_num)(verified_blocks)(errors))
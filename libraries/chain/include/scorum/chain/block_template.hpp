@@ -0,0 +1,82 @@
+#pragma once
+
+#include <scorum/chain/mempool.hpp>
+
+#include <vector>
+
+namespace scorum {
+namespace chain {
+
+using scorum::protocol::block_id_type;
+using scorum::protocol::checksum_type;
+using scorum::protocol::digest_type;
+
+/**
+ *  Candidate block maintained while pending transactions are applied to the pending session.
+ *
+ *  The template follows the mempool: every transaction applied on top of head is added to it in
+ *  the same order, together with its size and merkle leaf. When a block is generated on the same
+ *  head and the template still covers the whole mempool, the pending state already is the state
+ *  of the candidate block and only the header has to be finalized.
+ */
+class block_template
+{
+public:
+    /**
+     * Start a new empty candidate on top of given head block.
+     */
+    void reset(const block_id_type& head_id);
+
+    void push(const pending_transaction& ptx, uint32_t skip);
+
+    /**
+     * Check whether the candidate can be used as is for a block at given time.
+     *
+     * @param head_id current head block
+     * @param pending_count number of transactions in the mempool
+     * @param when block timestamp
+     * @param max_transactions_size maximum total size of transactions in the block
+     * @param skip validation steps skipped by block generation
+     */
+    bool is_usable(const block_id_type& head_id,
+                   size_t pending_count,
+                   fc::time_point_sec when,
+                   uint64_t max_transactions_size,
+                   uint32_t skip) const;
+
+    size_t size() const
+    {
+        return _count;
+    }
+
+    uint64_t total_size() const
+    {
+        return _total_size;
+    }
+
+    /**
+     * Same value as signed_block::calculate_merkle_root() for the transactions of the candidate.
+     */
+    checksum_type merkle_root() const;
+
+private:
+    struct merkle_node
+    {
+        digest_type digest;
+        uint32_t height;
+    };
+
+    block_id_type _head_id;
+    size_t _count = 0;
+    uint64_t _total_size = 0;
+    fc::time_point_sec _min_expiration = fc::time_point_sec::maximum();
+
+    /// union of validation steps skipped while applying transactions of the candidate
+    uint32_t _skip = 0;
+
+    /// roots of complete subtrees, heights are strictly decreasing
+    std::vector<merkle_node> _merkle_peaks;
+};
+
+} // namespace chain
+} // namespace scorum
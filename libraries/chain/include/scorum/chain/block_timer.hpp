@@ -0,0 +1,142 @@
+#pragma once
+
+#include <fc/reflect/reflect.hpp>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace scorum {
+namespace chain {
+
+struct block_phase_stats
+{
+    std::string phase;
+
+    /// time of the last applied block
+    uint64_t last_us = 0;
+
+    /// over blocks of the window
+    uint64_t avg_us = 0;
+    uint64_t p50_us = 0;
+    uint64_t p90_us = 0;
+    uint64_t p99_us = 0;
+    uint64_t max_us = 0;
+};
+
+struct block_timing_stats
+{
+    uint32_t last_block_num = 0;
+
+    /// number of blocks statistics are collected over
+    uint32_t window = 0;
+
+    uint64_t slow_blocks = 0;
+
+    block_phase_stats total;
+    std::vector<block_phase_stats> phases;
+};
+
+/**
+ *  Time spent in phases of block application over a rolling window of recently applied blocks.
+ *
+ *  A phase is closed by end_phase, which adds the time since the previous phase was closed (or the block was
+ *  started) to the given phase, so phases interleaved with others are summed up. Blocks which failed to apply
+ *  are not accounted.
+ */
+class block_timer
+{
+public:
+    enum phase_type : uint8_t
+    {
+        header = 0,
+        transactions,
+        global_properties,
+        irreversible_block,
+        expirations,
+        witness_schedule,
+        funds,
+        comment_cashout,
+        vesting_withdrawals,
+        hardforks,
+        applied_block_handlers,
+
+        phase_count
+    };
+
+    using clock = std::chrono::steady_clock;
+
+    static const uint32_t default_window = 1200;
+
+    explicit block_timer(uint32_t window = default_window);
+
+    void start_block();
+    void end_phase(phase_type phase);
+
+    /**
+     * @return total time of the block in microseconds
+     */
+    uint64_t end_block(uint32_t block_num);
+
+    /**
+     * Blocks which took longer are counted as slow, zero disables the check.
+     */
+    void set_slow_block_threshold(uint64_t us)
+    {
+        _slow_block_us = us;
+    }
+
+    bool is_slow(uint64_t total_us) const
+    {
+        return _slow_block_us != 0 && total_us > _slow_block_us;
+    }
+
+    /**
+     * Phases of the last block as "phase: time" pairs.
+     */
+    std::string get_last_block_breakdown() const;
+
+    block_timing_stats get_stats() const;
+
+    static const char* get_phase_name(phase_type phase);
+
+private:
+    // phase times and the total in microseconds
+    using block_times = std::array<uint64_t, phase_count + 1>;
+
+    block_phase_stats get_phase_stats(size_t phase, const char* name) const;
+
+    uint32_t _window;
+    std::vector<block_times> _history;
+    size_t _next = 0;
+
+    block_times _current = {};
+    clock::time_point _block_start;
+    clock::time_point _phase_start;
+
+    uint32_t _last_block_num = 0;
+    uint64_t _slow_block_us = 0;
+    uint64_t _slow_blocks = 0;
+};
+
+} // namespace chain
+} // namespace scorum
+
+// clang-format off
+FC_REFLECT(scorum::chain::block_phase_stats,
+           (phase)
+           (last_us)
+           (avg_us)
+           (p50_us)
+           (p90_us)
+           (p99_us)
+           (max_us))
+
+FC_REFLECT(scorum::chain::block_timing_stats,
+           (last_block_num)
+           (window)
+           (slow_blocks)
+           (total)
+           (phases))
+// clang-format on
@@ -19,6 +19,11 @@
     virtual DECLARE_SERVICE_INTERFACE_NAME(service)                                                                    \
         & BOOST_PP_CAT(DECLARE_SERVICE_FUNCT_NAME(service), BOOST_PP_EMPTY())();
 
+#define DECLARE_SERVICE_MEMBER_NAME(service) BOOST_PP_CAT(_, DECLARE_SERVICE_FUNCT_NAME(service))
+
+#define DECLARE_FACTORY_MEMBER(_1, _2, service)                                                                        \
+    DECLARE_SERVICE_INTERFACE_NAME(service) & DECLARE_SERVICE_MEMBER_NAME(service);
+
 #define DATA_SERVICE_FACTORY_DECLARE(SERVICES)                                                                         \
     namespace scorum {                                                                                                 \
     namespace chain {                                                                                                  \
@@ -43,6 +48,9 @@
                                                                                                                        \
     private:                                                                                                           \
         scorum::chain::dbservice_dbs_factory& factory;                                                                 \
+                                                                                                                       \
+        /* services are created with the factory and accessed without lookups */                                       \
+        BOOST_PP_SEQ_FOR_EACH(DECLARE_FACTORY_MEMBER, _, SERVICES)                                                     \
     };                                                                                                                 \
     }                                                                                                                  \
     }
@@ -51,14 +59,17 @@
     DECLARE_SERVICE_INTERFACE_NAME(service)                                                                            \
     &data_service_factory::BOOST_PP_CAT(DECLARE_SERVICE_FUNCT_NAME(service), BOOST_PP_EMPTY())()                       \
     {                                                                                                                  \
-        return factory.obtain_service<DECLARE_DBS_IMPL_NAME(service)>();                                               \
+        return DECLARE_SERVICE_MEMBER_NAME(service);                                                                   \
     }
 
+#define DECLARE_FACTORY_MEMBER_INIT(_1, _2, service)                                                                   \
+    , DECLARE_SERVICE_MEMBER_NAME(service)(factory.obtain_service<DECLARE_DBS_IMPL_NAME(service)>())
+
 #define DATA_SERVICE_FACTORY_IMPL(SERVICES)                                                                            \
     namespace scorum {                                                                                                 \
     namespace chain {                                                                                                  \
     data_service_factory::data_service_factory(scorum::chain::database& db)                                            \
-        : factory(db)                                                                                                  \
+        : factory(db) BOOST_PP_SEQ_FOR_EACH(DECLARE_FACTORY_MEMBER_INIT, _, SERVICES)                                  \
     {                                                                                                                  \
     }                                                                                                                  \
                                                                                                                        \
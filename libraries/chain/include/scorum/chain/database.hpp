@@ -8,7 +8,17 @@
 #include <scorum/chain/node_property_object.hpp>
 #include <scorum/chain/fork_database.hpp>
 #include <scorum/chain/block_log.hpp>
+#include <scorum/chain/block_cache.hpp>
+#include <scorum/chain/mempool.hpp>
+#include <scorum/chain/block_template.hpp>
+#include <scorum/chain/due_event_scheduler.hpp>
+#include <scorum/chain/account_delta_buffer.hpp>
+#include <scorum/chain/authority_cache.hpp>
+#include <scorum/chain/operation_profiler.hpp>
+#include <scorum/chain/block_timer.hpp>
+#include <scorum/chain/async_indexer.hpp>
 #include <scorum/chain/operation_notification.hpp>
+#include <scorum/chain/operation_handlers.hpp>
 
 #include <scorum/protocol/protocol.hpp>
 
@@ -33,7 +43,9 @@ using scorum::protocol::price;
 using scorum::protocol::signed_transaction;
 
 class database_impl;
+class decline_voting_rights_request_object;
 class custom_operation_interpreter;
+class history_store;
 struct genesis_state_type;
 
 /**
@@ -121,6 +133,21 @@ public:
     block_id_type get_block_id_for_num(uint32_t block_num) const;
     optional<signed_block> fetch_block_by_id(const block_id_type& id) const;
     optional<signed_block> fetch_block_by_number(uint32_t num) const;
+
+    /**
+     *  Blocks shared with the block cache and the fork database, they are not copied.
+     */
+    block_cache::block_ptr fetch_shared_block_by_id(const block_id_type& id) const;
+    block_cache::block_ptr fetch_shared_block_by_number(uint32_t num) const;
+
+    /**
+     *  Header queries are served from the header index of the block log, irreversible
+     *  blocks are not decoded.
+     */
+    optional<block_header> fetch_block_header_by_id(const block_id_type& id) const;
+    optional<block_header> fetch_block_header_by_number(uint32_t num) const;
+    std::vector<block_header_record>
+    fetch_block_headers_by_time(time_point_sec start, time_point_sec end, uint32_t limit) const;
     const signed_transaction get_recent_transaction(const transaction_id_type& trx_id) const;
     std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
 
@@ -164,11 +191,47 @@ public:
     bool before_last_checkpoint() const;
 
     bool push_block(const signed_block& b, uint32_t skip = skip_nothing);
+
+    /**
+     * Results of checks of a block which do not depend on chain state.
+     */
+    struct prevalidated_block
+    {
+        /// skip flags of passed checks
+        uint32_t skip = skip_nothing;
+
+        /// key recovered from the witness signature, it is not set if the signature is invalid
+        optional<public_key_type> signee;
+
+        /// keys recovered from signatures of every transaction, they are not set if signatures are invalid
+        std::vector<optional<fc::flat_set<public_key_type>>> signature_keys;
+    };
+
+    /**
+     * Run checks of the block which do not depend on chain state (merkle root, validation of transactions) and
+     * recover keys from signatures of the block and its transactions unless the signature checks are skipped.
+     * Database locks are not needed, so it is done before the block is pushed. Failed checks are repeated by
+     * push_block.
+     */
+    static prevalidated_block
+    prevalidate_block(const signed_block& b, const chain_id_type& chain_id, uint32_t skip = skip_nothing);
+
+    /**
+     * Push block prevalidated by prevalidate_block, passed checks are skipped and signatures are verified by
+     * comparing recovered keys with keys of the chain state.
+     */
+    bool push_block(const signed_block& b, const prevalidated_block& prevalidated, uint32_t skip = skip_nothing);
+
     void push_transaction(const signed_transaction& trx, uint32_t skip = skip_nothing);
     void _maybe_warn_multiple_production(uint32_t height) const;
-    bool _push_block(const signed_block& b);
+    bool _push_block(const signed_block& b, const prevalidated_block* prevalidated = nullptr);
     void _push_transaction(const signed_transaction& trx);
 
+    /**
+     * Apply pending transaction, validation and signature checks are skipped if it is already verified.
+     */
+    void _push_pending_transaction(pending_transaction&& ptx);
+
     signed_block generate_block(const fc::time_point_sec when,
                                 const account_name_type& witness_owner,
                                 const fc::ecc::private_key& block_signing_private_key,
@@ -179,6 +242,12 @@ public:
 
     void pop_block();
     void clear_pending();
+    mempool_stats get_mempool_stats() const;
+
+    const due_event_scheduler& get_due_events() const
+    {
+        return _due_events;
+    }
 
     /**
      *  This method is used to track applied operations during the evaluation of a block, these
@@ -204,6 +273,13 @@ public:
     fc::signal<void(const operation_notification&)> pre_apply_operation;
     fc::signal<void(const operation_notification&)> post_apply_operation;
 
+    /**
+     *  Handlers of particular operation types, called after the signals above. Plugins which process a few
+     *  operation types should register here instead of visiting every operation.
+     */
+    operation_handlers pre_apply_operation_handlers;
+    operation_handlers post_apply_operation_handlers;
+
     /**
      *  This signal is emitted after all operations and virtual operation for a
      *  block have been applied but before the get_applied_operations() are cleared.
@@ -296,14 +372,22 @@ public:
      * witness vote totals.  Vote totals should be updated first via a call to
      * adjust_proxied_witness_votes( a, -a.witness_vote_weight() )
      */
-    void process_vesting_withdrawals();
-    share_type pay_curators(const comment_object& c, share_type& max_rewards);
-    share_type cashout_comment_helper(const share_type& reward, const comment_object& comment);
+    void process_vesting_withdrawal(const account_object& from_account);
+
+    /// voters and their curation rewards in order of the comment votes
+    using curator_claims = std::vector<std::pair<account_id_type, share_type>>;
+
+    /**
+     * Split curation rewards of the comment between voters, does not modify the database so it can be
+     * called from worker threads.
+     */
+    curator_claims get_curator_claims(const comment_object& c, const share_type& max_rewards) const;
+    share_type pay_curators(const comment_object& c, const curator_claims& claims, share_type& max_rewards);
+    share_type
+    cashout_comment_helper(const share_type& reward, const comment_object& comment, const curator_claims& claims);
     void process_comment_cashout();
     void process_funds();
-    void account_recovery_processing();
-    void expire_escrow_ratification();
-    void process_decline_voting_rights();
+    void process_decline_voting_rights(const decline_voting_rights_request_object& request);
 
     time_point_sec head_block_time() const;
     uint32_t head_block_num() const;
@@ -343,12 +427,84 @@ public:
        with id N, applies all hardforks with id <= N */
     void set_hardfork(uint32_t hardfork, bool process_now = true);
 
+    /**
+     * Check the total supply against running totals, takes constant time and runs after every block
+     * unless skip_validate_invariants is set.
+     */
     void validate_invariants() const;
+
+    /**
+     * Recompute totals by scanning all objects, check them against running totals and validate invariants.
+     */
+    void audit_invariants() const;
     /**
      * @}
      */
 
     void set_flush_interval(uint32_t flush_blocks);
+
+    /**
+     * Split the block log into segments of given number of blocks, zero keeps a single file. Must be set before open.
+     */
+    void set_block_log_segment_size(uint32_t blocks);
+
+    /**
+     * Keep at least given number of irreversible blocks in the block log and remove older segments
+     * when the shared memory file is flushed, zero keeps the full history.
+     */
+    void set_block_log_retain_blocks(uint32_t blocks);
+
+    /**
+     * Set the number of recently accessed blocks kept decoded in memory, zero disables the cache.
+     */
+    void set_block_cache_size(uint32_t blocks);
+    block_cache_stats get_block_cache_stats() const;
+
+    /**
+     * Log phase breakdown of blocks which took longer to apply than given number of milliseconds, zero disables it.
+     */
+    void set_slow_block_threshold(uint32_t ms);
+    block_timing_stats get_block_timing_stats() const;
+
+    /**
+     * Enable the operation profiler and log collected profiles every given number of blocks, zero disables logging.
+     */
+    void set_operation_profile_interval(uint32_t blocks);
+
+    operation_profiler& get_operation_profiler()
+    {
+        return _operation_profiler;
+    }
+
+    const operation_profiler& get_operation_profiler() const
+    {
+        return _operation_profiler;
+    }
+
+    async_indexer& get_async_indexer()
+    {
+        return _async_indexer;
+    }
+
+    async_indexer_stats get_async_indexer_stats() const
+    {
+        return _async_indexer.get_stats();
+    }
+
+    /**
+     * Account history kept outside of shared memory, it is set by the account_history plugin when the history is
+     * indexed asynchronously.
+     */
+    void set_history_store(std::shared_ptr<history_store> store)
+    {
+        _history_store = store;
+    }
+
+    std::shared_ptr<history_store> get_history_store() const
+    {
+        return _history_store;
+    }
+
     void show_free_memory(bool force);
 
     // witness_schedule
@@ -365,6 +521,29 @@ public:
 private:
     void adjust_balance(const account_object& a, const asset& delta);
 
+    authority get_authority(const account_name_type& name, authority_cache::authority_type type) const;
+
+    /**
+     * Verify signatures of the transaction against authorities, keys are recovered from the signatures unless
+     * they are given.
+     */
+    void verify_authority(const signed_transaction& trx,
+                          const fc::flat_set<public_key_type>* signature_keys = nullptr) const;
+
+    /**
+     * Verify signatures of block transactions in parallel against the state before the block. A result is kept
+     * only if no earlier transaction of the block updates authorities the transaction depends on, other
+     * transactions are verified on apply.
+     * @return flags of verified transactions
+     */
+    std::vector<uint8_t> verify_block_authorities(const signed_block& b,
+                                                  const prevalidated_block* prevalidated) const;
+
+    /**
+     * Return accounts whose authorities can be used to satisfy authorities required by the transaction.
+     */
+    fc::flat_set<account_name_type> get_authority_accounts(const signed_transaction& trx) const;
+
     void _reset_virtual_schedule_time();
 
     void _update_median_witness_props();
@@ -377,23 +556,29 @@ protected:
         _is_producing = p;
     }
 
-    void apply_block(const signed_block& next_block, uint32_t skip = skip_nothing);
-    void apply_transaction(const signed_transaction& trx, uint32_t skip = skip_nothing);
-    void _apply_block(const signed_block& next_block);
-    void _apply_transaction(const signed_transaction& trx);
+    void apply_block(const signed_block& next_block,
+                     uint32_t skip = skip_nothing,
+                     const prevalidated_block* prevalidated = nullptr);
+    void apply_transaction(const signed_transaction& trx,
+                           uint32_t skip = skip_nothing,
+                           const fc::flat_set<public_key_type>* signature_keys = nullptr);
+    void _apply_block(const signed_block& next_block, const prevalidated_block* prevalidated);
+    void _apply_transaction(const signed_transaction& trx,
+                            const fc::flat_set<public_key_type>* signature_keys = nullptr);
     void apply_operation(const operation& op);
 
     /// Steps involved in applying a new block
     ///@{
 
-    const witness_object& validate_block_header(uint32_t skip, const signed_block& next_block) const;
+    const witness_object& validate_block_header(uint32_t skip,
+                                                const signed_block& next_block,
+                                                const prevalidated_block* prevalidated) const;
     void create_block_summary(const signed_block& next_block);
 
     void update_global_dynamic_data(const signed_block& b);
     void update_signing_witness(const witness_object& signing_witness, const signed_block& new_block);
     void update_last_irreversible_block();
-    void clear_expired_transactions();
-    void clear_expired_delegations();
+    void init_due_events();
     void process_header_extensions(const signed_block& next_block);
 
     void init_hardforks(fc::time_point_sec genesis_time);
@@ -408,12 +593,23 @@ private:
 
     optional<chainbase::abstract_undo_session_ptr> _pending_tx_session;
 
-    std::vector<signed_transaction> _pending_tx;
+    mempool _pending_tx;
+    block_template _block_template;
+    due_event_scheduler _due_events;
+    account_delta_buffer _account_deltas;
+
+    // authorities resolved while transactions of a block are verified
+    mutable authority_cache _authority_cache;
+    operation_profiler _operation_profiler;
+    block_timer _block_timer;
+    async_indexer _async_indexer;
+    std::shared_ptr<history_store> _history_store;
     fork_database _fork_db;
     fc::time_point_sec _hardfork_times[SCORUM_NUM_HARDFORKS + 1];
     protocol::hardfork_version _hardfork_versions[SCORUM_NUM_HARDFORKS + 1];
 
     block_log _block_log;
+    block_cache _block_cache;
 
     fc::signal<void()> _plugin_index_signal;
 
@@ -429,6 +625,11 @@ private:
     uint32_t _flush_blocks = 0;
     uint32_t _next_flush_block = 0;
 
+    uint32_t _operation_profile_blocks = 0;
+
+    uint32_t _block_log_segment_blocks = 0;
+    uint32_t _block_log_retain_blocks = 0;
+
     uint32_t _last_free_gb_printed = 0;
 
     flat_map<std::string, std::shared_ptr<custom_operation_interpreter>> _custom_operation_interpreters;
@@ -40,6 +40,24 @@ struct skip_flags_restorer
     uint32_t _old_skip_flags; // initialized in ctor
 };
 
+/**
+ * Class used to help the with_authority_cache implementation.
+ */
+struct authority_cache_disabler
+{
+    authority_cache_disabler(authority_cache& cache)
+        : _cache(cache)
+    {
+    }
+
+    ~authority_cache_disabler()
+    {
+        _cache.disable();
+    }
+
+    authority_cache& _cache;
+};
+
 /**
  * Class used to help the without_pending_transactions
  * implementation.
@@ -49,15 +67,23 @@ struct skip_flags_restorer
  */
 struct pending_transactions_restorer
 {
-    pending_transactions_restorer(database& db, std::vector<signed_transaction>&& pending_transactions)
+    pending_transactions_restorer(database& db, mempool& pending_transactions, const signed_block& new_block)
         : _db(db)
-        , _pending_transactions(std::move(pending_transactions))
+        , _db_pending_transactions(pending_transactions)
+        , _old_head_id(db.head_block_id())
+        , _new_block(new_block)
     {
+        _pending_transactions.swap(pending_transactions);
         _db.clear_pending();
     }
 
     ~pending_transactions_restorer()
     {
+        fc::time_point start = fc::time_point::now();
+        uint32_t reapplied = 0;
+        uint32_t revalidated = 0;
+        uint32_t dropped = 0;
+
         for (const auto& tx : _db._popped_tx)
         {
             try
@@ -67,33 +93,55 @@ struct pending_transactions_restorer
                     // since push_transaction() takes a signed_transaction,
                     // the operation_results field will be ignored.
                     _db._push_transaction(tx);
+                    ++revalidated;
                 }
             }
             catch (const fc::exception&)
             {
+                ++dropped;
             }
         }
         _db._popped_tx.clear();
-        for (const signed_transaction& tx : _pending_transactions)
+
+        // Signatures of pending transactions stay valid unless authorities they depend on have changed.
+        // That is known only if the new block was applied directly on top of the old head.
+        if (_db.head_block_id() == _new_block.id() && _new_block.previous == _old_head_id)
+        {
+            _pending_transactions.invalidate(mempool::get_authority_updates(_new_block));
+        }
+        else if (_db.head_block_id() != _old_head_id)
+        {
+            _pending_transactions.invalidate_all();
+        }
+
+        dropped += _pending_transactions.remove_expired(_db.head_block_time());
+
+        // authority updates of dropped transactions are not applied, so transactions verified against them
+        // are invalidated as they are dropped
+        for (const pending_transaction& ptx : _pending_transactions.transactions())
         {
             try
             {
-                if (!_db.is_known_transaction(tx.id()))
+                if (!_db.is_known_transaction(ptx.id))
                 {
-                    // since push_transaction() takes a signed_transaction,
-                    // the operation_results field will be ignored.
-                    _db._push_transaction(tx);
+                    bool verified = ptx.verified;
+                    _db._push_pending_transaction(pending_transaction(ptx));
+                    ++(verified ? reapplied : revalidated);
                 }
             }
             catch (const transaction_exception& e)
             {
+                ++dropped;
+                _pending_transactions.invalidate(mempool::get_authority_updates(ptx.trx));
                 dlog("Pending transaction became invalid after switching to block ${b} ${n} ${t}",
                      ("b", _db.head_block_id())("n", _db.head_block_num())("t", _db.head_block_time()));
                 dlog("The invalid transaction caused exception ${e}", ("e", e.to_detail_string()));
-                dlog("${t}", ("t", tx));
+                dlog("${t}", ("t", ptx.trx));
             }
             catch (const fc::exception& e)
             {
+                ++dropped;
+                _pending_transactions.invalidate(mempool::get_authority_updates(ptx.trx));
 
                 /*
                 dlog( "Pending transaction became invalid after switching to block ${b} ${n} ${t}",
@@ -103,10 +151,15 @@ struct pending_transactions_restorer
                 */
             }
         }
+
+        _db_pending_transactions.record_reapply(reapplied, revalidated, dropped, fc::time_point::now() - start);
     }
 
     database& _db;
-    std::vector<signed_transaction> _pending_transactions;
+    mempool& _db_pending_transactions;
+    mempool _pending_transactions;
+    block_id_type _old_head_id;
+    const signed_block& _new_block;
 };
 
 /**
@@ -124,15 +177,29 @@ template <typename Lambda> void with_skip_flags(database& db, uint32_t skip_flag
 }
 
 /**
- * Empty pending_transactions, call callback,
+ * Cache authorities while callback is running, the cache is dropped after callback is done.
+ */
+template <typename Lambda> void with_authority_cache(authority_cache& cache, Lambda callback)
+{
+    cache.enable();
+    authority_cache_disabler disabler(cache);
+    callback();
+    return;
+}
+
+/**
+ * Empty pending_transactions, call callback pushing new_block,
  * then reset pending_transactions after callback is done.
  *
  * Pending transactions which no longer validate will be culled.
  */
 template <typename Lambda>
-void without_pending_transactions(database& db, std::vector<signed_transaction>&& pending_transactions, Lambda callback)
+void without_pending_transactions(database& db,
+                                  mempool& pending_transactions,
+                                  const signed_block& new_block,
+                                  Lambda callback)
 {
-    pending_transactions_restorer restorer(db, std::move(pending_transactions));
+    pending_transactions_restorer restorer(db, pending_transactions, new_block);
     callback();
     return;
 }
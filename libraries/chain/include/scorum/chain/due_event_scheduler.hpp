@@ -0,0 +1,92 @@
+#pragma once
+
+#include <fc/optional.hpp>
+#include <fc/time.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <array>
+#include <functional>
+
+namespace scorum {
+namespace chain {
+
+/**
+ * Kinds of time-driven maintenance events, in the order they are processed within a block.
+ */
+enum due_event_kind : uint8_t
+{
+    transaction_expiration = 0,
+    vesting_delegation_expiration,
+    atomicswap_contract_expiration,
+    vesting_withdrawal,
+    account_recovery_request_expiration,
+    owner_authority_history_expiration,
+    recovery_account_change,
+    escrow_ratification_expiration,
+    voting_rights_decline,
+    proposal_expiration,
+
+    due_event_kinds_count
+};
+
+/**
+ *  Deterministic dispatcher of time-driven per-block maintenance.
+ *
+ *  Events of every kind are kept in chain state by an index of their objects ordered by the time the
+ *  event becomes due (transaction expiration, delegation expiration, next vesting withdrawal etc.),
+ *  so the earliest event of a kind is always the first element of its index. A kind is registered
+ *  with a function returning the due time of its earliest event and a function processing that event.
+ *
+ *  Events are popped in (kind, due time, object id) order and only while they are due, so the cost
+ *  of maintenance is proportional to the number of processed events plus one lookup per kind.
+ */
+class due_event_scheduler
+{
+public:
+    /// due time of the earliest event, empty if there are no events of the kind
+    using next_due_type = std::function<fc::optional<fc::time_point_sec>()>;
+
+    /// process the earliest event, the event must not be returned by next_due afterwards
+    using process_type = std::function<void()>;
+
+    void set_handler(due_event_kind kind, next_due_type next_due, process_type process);
+
+    /**
+     * Process events of kinds [first, last] which are due at given time.
+     * @return number of processed events
+     */
+    uint32_t process(due_event_kind first, due_event_kind last, fc::time_point_sec now);
+
+    /**
+     * Total number of processed events of given kind.
+     */
+    uint64_t processed(due_event_kind kind) const;
+
+private:
+    struct handler
+    {
+        next_due_type next_due;
+        process_type process;
+        uint64_t processed = 0;
+    };
+
+    std::array<handler, due_event_kinds_count> _handlers;
+};
+
+} // namespace chain
+} // namespace scorum
+
+// clang-format off
+FC_REFLECT_ENUM(scorum::chain::due_event_kind,
+                (transaction_expiration)
+                (vesting_delegation_expiration)
+                (atomicswap_contract_expiration)
+                (vesting_withdrawal)
+                (account_recovery_request_expiration)
+                (owner_authority_history_expiration)
+                (recovery_account_change)
+                (escrow_ratification_expiration)
+                (voting_rights_decline)
+                (proposal_expiration)
+                (due_event_kinds_count))
+// clang-format on
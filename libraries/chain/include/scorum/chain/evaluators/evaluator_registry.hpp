@@ -1,22 +1,29 @@
 #pragma once
 
 #include <scorum/chain/evaluators/evaluator.hpp>
+#include <scorum/chain/util/static_variant.hpp>
+
+#include <array>
+#include <memory>
 
 namespace scorum {
 namespace chain {
 
 class database;
 
+/**
+ * Evaluators in a table sized at compile time and indexed by operation tag.
+ */
 template <typename OperationType> class evaluator_registry
 {
 public:
     typedef OperationType operation_type;
 
+    static const size_t operation_count = util::static_variant_size<OperationType>::value;
+
     evaluator_registry(database& d)
         : _db(d)
     {
-        for (int i = 0; i < OperationType::count(); i++)
-            _op_evaluators.emplace_back();
     }
 
     template <typename EvaluatorType, typename... Args> void register_evaluator(Args... args)
@@ -44,7 +51,7 @@ public:
         return *eval;
     }
 
-    std::vector<std::unique_ptr<evaluator<OperationType>>> _op_evaluators;
+    std::array<std::unique_ptr<evaluator<OperationType>>, operation_count> _op_evaluators;
     database& _db;
 };
 
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <scorum/chain/async_indexer.hpp>
+
+#include <fc/filesystem.hpp>
+#include <fc/optional.hpp>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace boost {
+namespace interprocess {
+class mapped_region;
+}
+} // namespace boost::interprocess
+
+namespace scorum {
+namespace chain {
+
+struct history_entry
+{
+    indexed_operation op;
+    std::vector<account_name_type> accounts;
+};
+
+struct history_store_state
+{
+    /// operations of blocks up to this one are written to the files
+    uint32_t committed_block_num = 0;
+
+    uint64_t operations = 0;
+    uint64_t transactions = 0;
+};
+
+/**
+ *  Account history kept outside of shared memory, it is filled by the account_history plugin from the
+ *  async_indexer thread and read by APIs.
+ *
+ *  Operations are appended in order of application, each one with accounts it is in the history of. A sequence
+ *  number of an operation in the history of an account is the number of earlier operations of the account. A
+ *  position of an operation is the number of earlier operations in the store.
+ *
+ *  Operations of blocks which can still be popped are kept in memory. When the store is opened, operations of
+ *  irreversible blocks are moved to append only files of the directory every commit_blocks blocks and on flush:
+ *
+ *  operations.<segment>.log  packed operations, a new segment is started every operations_per_segment operations
+ *  operations.index          fixed width record per position: offset in the segment, block number and size
+ *  accounts/<account>.index  position of every operation of the account history, so a record offset is
+ *                            8 * sequence
+ *  transactions.index        position of the first operation of every transaction
+ *  state.json                number of committed records, files are truncated to it on open
+ *  window.bin                operations kept in memory when the files were written, so they survive a restart
+ *
+ *  Appended files and the directory are synced before state.json is replaced, so committed records survive a
+ *  crash. Records written after the last saved state are dropped on open, and files shorter than the saved state
+ *  fail the open. Blocks indexed after the last write are indexed again when the chain is replayed after a crash.
+ *
+ *  Records of a failed write are truncated, so the next write follows the saved state. If the files can not be
+ *  truncated, the store stops writing them.
+ *
+ *  Files are read through memory mappings. Transaction positions are loaded to memory by a 64-bit prefix of the
+ *  transaction id.
+ */
+class history_store
+{
+public:
+    static const uint64_t default_operations_per_segment = 1 << 20;
+    static const uint32_t default_commit_blocks = 1000;
+
+    explicit history_store(uint64_t operations_per_segment = default_operations_per_segment,
+                           uint32_t commit_blocks = default_commit_blocks);
+    ~history_store();
+
+    /**
+     * Keep operations of irreversible blocks in files of the directory. Operations of blocks above the
+     * committed block are reloaded from the window file.
+     */
+    void open(const fc::path& dir);
+
+    /**
+     * Append an operation of a block which is not lower than the head block.
+     */
+    void append(const indexed_operation& op, const std::vector<account_name_type>& accounts);
+
+    /**
+     * Mark block as processed, blocks without tracked operations still move the head block.
+     */
+    void set_head_block_num(uint32_t block_num);
+
+    /**
+     * Remove operations of blocks above the given one, committed blocks can not be removed.
+     */
+    void pop_blocks(uint32_t block_num);
+
+    /**
+     * Mark blocks up to the given one as irreversible, their operations are written to the files when
+     * commit_blocks blocks are collected.
+     */
+    void commit(uint32_t block_num);
+
+    /**
+     * Write operations of irreversible blocks and the window to the files, it does nothing if the store is not
+     * opened.
+     */
+    void flush();
+
+    uint32_t head_block_num() const;
+    uint32_t committed_block_num() const;
+
+    /**
+     * Operations of the account history with sequence numbers in [from - limit, from].
+     */
+    std::map<uint32_t, indexed_operation>
+    get_account_history(const account_name_type& account, uint64_t from, uint32_t limit) const;
+
+    std::vector<indexed_operation> get_ops_in_block(uint32_t block_num) const;
+
+    /**
+     * The first operation of the transaction.
+     */
+    fc::optional<indexed_operation> find_transaction(const transaction_id_type& trx_id) const;
+
+private:
+    struct operation_record
+    {
+        uint64_t offset;
+        uint32_t block;
+        uint32_t size;
+    };
+
+    using region_ptr = std::unique_ptr<boost::interprocess::mapped_region>;
+
+    void append_entry(history_entry&& e);
+
+    void write_files();
+    void write_operations(size_t count);
+    void write_window() const;
+    void save_state() const;
+    void check_files() const;
+    void truncate_files();
+    void load_transactions();
+    void map_files();
+
+    operation_record get_record(uint64_t position) const;
+    indexed_operation get_operation(uint64_t position) const;
+    uint64_t get_account_operations(const account_name_type& account) const;
+
+    fc::path segment_file(uint64_t segment) const;
+    fc::path account_file(const account_name_type& account) const;
+
+    static uint64_t get_prefix(const transaction_id_type& trx_id);
+
+    mutable std::mutex _mutex;
+
+    const uint64_t _operations_per_segment;
+    const uint32_t _commit_blocks;
+
+    bool _open = false;
+    bool _failed = false;
+    fc::path _dir;
+    history_store_state _state;
+
+    // operations of blocks above the committed one, the first one is at position _state.operations
+    std::deque<history_entry> _window;
+
+    // positions of window operations ordered by sequence
+    std::map<account_name_type, std::deque<uint64_t>> _account_operations;
+    std::map<transaction_id_type, uint64_t> _transactions;
+
+    // committed transactions by id prefix
+    std::unordered_multimap<uint64_t, uint64_t> _committed_transactions;
+
+    region_ptr _index_region;
+    mutable std::vector<region_ptr> _segment_regions;
+
+    uint32_t _head_block_num = 0;
+    uint32_t _irreversible_block_num = 0;
+};
+
+} // namespace chain
+} // namespace scorum
+
+// clang-format off
+FC_REFLECT(scorum::chain::history_entry,
+           (op)
+           (accounts))
+
+FC_REFLECT(scorum::chain::history_store_state,
+           (committed_block_num)
+           (operations)
+           (transactions))
+// clang-format on
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <scorum/protocol/block.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+#include <map>
+
+namespace scorum {
+namespace chain {
+
+using scorum::protocol::account_name_type;
+using scorum::protocol::signed_block;
+using scorum::protocol::signed_transaction;
+using scorum::protocol::transaction_id_type;
+
+struct pending_transaction
+{
+    pending_transaction() = default;
+    explicit pending_transaction(const signed_transaction& t);
+
+    signed_transaction trx;
+    transaction_id_type id;
+    fc::time_point_sec expiration;
+    uint32_t size = 0;
+
+    /// accounts whose authorities were used to verify signatures of the transaction
+    fc::flat_set<account_name_type> authority_accounts;
+
+    /// transaction was validated and its signatures were verified against authorities of the current state
+    bool verified = false;
+
+    /**
+     * Check if signatures were verified against authority of any of given accounts.
+     */
+    bool depends_on(const fc::flat_set<account_name_type>& accounts) const;
+};
+
+struct mempool_stats
+{
+    uint32_t pending = 0;
+    uint64_t pending_size = 0;
+
+    /// transactions re-applied without validation and signature checks
+    uint64_t reapplied = 0;
+
+    /// transactions re-applied with full checks
+    uint64_t revalidated = 0;
+
+    /// transactions dropped on re-apply (expired or became invalid)
+    uint64_t dropped = 0;
+
+    uint64_t last_reapply_time_us = 0;
+    uint64_t total_reapply_time_us = 0;
+};
+
+/**
+ *  Pending transactions in order of arrival.
+ *
+ *  After a block is applied every pending transaction has to be re-applied on top of the new state,
+ *  but validation and signature checks only depend on the transaction itself and on the authorities
+ *  of the accounts in authority_accounts. Transactions are kept marked as verified unless a block
+ *  changes one of these authorities, so re-applying them skips the checks. Pending transactions that
+ *  update authorities and are dropped invalidate the transactions verified against their updates too.
+ */
+class mempool
+{
+public:
+    struct by_id;
+    struct by_expiration;
+
+    // clang-format off
+    using transactions_type = boost::multi_index_container<pending_transaction,
+                              boost::multi_index::indexed_by<boost::multi_index::sequenced<>,
+                                                             boost::multi_index::hashed_unique<boost::multi_index::tag<by_id>,
+                                                                                               boost::multi_index::member<pending_transaction, transaction_id_type, &pending_transaction::id>,
+                                                                                               std::hash<fc::ripemd160>>,
+                                                             boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_expiration>,
+                                                                                                    boost::multi_index::member<pending_transaction, fc::time_point_sec, &pending_transaction::expiration>>>>;
+    // clang-format on
+
+    bool contains(const transaction_id_type& id) const;
+    const pending_transaction* find(const transaction_id_type& id) const;
+
+    /**
+     * Append transaction, a transaction already in the pool is kept as is.
+     * @return the pooled transaction
+     */
+    const pending_transaction& push(pending_transaction&& ptx);
+    void clear();
+
+    /**
+     * Exchange transactions with other pool, statistics are not exchanged.
+     */
+    void swap(mempool& other);
+
+    /**
+     * Remove transactions expired before given time, transactions verified against authorities updated
+     * by removed ones are marked as not verified.
+     * @return number of removed transactions
+     */
+    uint32_t remove_expired(fc::time_point_sec now);
+
+    /**
+     * Mark transactions depending on authorities of given accounts as not verified.
+     */
+    void invalidate(const fc::flat_set<account_name_type>& accounts);
+    void invalidate_all();
+
+    const transactions_type& transactions() const
+    {
+        return _transactions;
+    }
+
+    size_t size() const
+    {
+        return _transactions.size();
+    }
+
+    uint64_t total_size() const
+    {
+        return _total_size;
+    }
+
+    void record_reapply(uint32_t reapplied, uint32_t revalidated, uint32_t dropped, const fc::microseconds& time);
+    mempool_stats get_stats() const;
+
+    /**
+     * Return accounts whose authorities are changed (or created) by operations of the transaction.
+     */
+    static fc::flat_set<account_name_type> get_authority_updates(const signed_transaction& trx);
+
+    /**
+     * Return accounts whose authorities are changed (or created) by operations of the block.
+     */
+    static fc::flat_set<account_name_type> get_authority_updates(const signed_block& b);
+
+private:
+    void _erase_accounts(const pending_transaction& ptx);
+
+    transactions_type _transactions;
+    std::multimap<account_name_type, transaction_id_type> _by_account;
+    uint64_t _total_size = 0;
+
+    mempool_stats _stats;
+};
+
+} // namespace chain
+} // namespace scorum
+
+FC_REFLECT(scorum::chain::mempool_stats,
+           (pending)(pending_size)(reapplied)(revalidated)(dropped)(last_reapply_time_us)(total_reapply_time_us))
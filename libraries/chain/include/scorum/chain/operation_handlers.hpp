@@ -0,0 +1,123 @@
+#pragma once
+
+#include <scorum/chain/operation_notification.hpp>
+#include <scorum/chain/util/static_variant.hpp>
+
+#include <array>
+#include <bitset>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace scorum {
+namespace chain {
+
+namespace detail {
+
+struct operation_not_handled
+{
+};
+
+// the template hides catch-all templates of the visitor, so only its overloads for operation types are found
+template <typename Visitor> struct visitor_probe : Visitor
+{
+    using Visitor::operator();
+
+    template <typename T> operation_not_handled operator()(const T&) const;
+};
+
+template <typename Visitor, typename Operation>
+struct visitor_handles
+    : std::integral_constant<bool,
+                             !std::is_same<decltype(std::declval<const visitor_probe<Visitor>&>()(
+                                               std::declval<const Operation&>())),
+                                           operation_not_handled>::value>
+{
+};
+
+template <typename Visitor, typename Variant> struct visitor_mask;
+
+template <typename Visitor, typename... Operations> struct visitor_mask<Visitor, fc::static_variant<Operations...>>
+{
+    static std::bitset<sizeof...(Operations)> get()
+    {
+        std::bitset<sizeof...(Operations)> mask;
+        size_t tag = 0;
+        for (bool handled : { visitor_handles<Visitor, Operations>::value... })
+        {
+            mask.set(tag++, handled);
+        }
+        return mask;
+    }
+};
+}
+
+/**
+ *  Plugin handlers of applied operations in a table indexed by operation tag.
+ *
+ *  A handler is registered for the operation types it processes and receives the operation already converted to
+ *  its type, so notifying about an operation only calls handlers of its type and operations without handlers cost
+ *  a table lookup. Handlers visiting operations of several types are registered with a mask of these types.
+ */
+class operation_handlers
+{
+public:
+    using handler_type = std::function<void(const operation_notification&)>;
+
+    static const size_t operation_count = util::static_variant_size<operation>::value;
+
+    /// set of operation types, bit i stands for operation tag i
+    using operation_mask = std::bitset<operation_count>;
+
+    template <typename... Operations> static operation_mask make_mask()
+    {
+        operation_mask mask;
+        for (size_t tag : { (size_t)operation::tag<Operations>::value... })
+        {
+            mask.set(tag);
+        }
+        return mask;
+    }
+
+    /**
+     * Mask of operation types the visitor has overloads for, a catch-all template of the visitor is not counted.
+     * The mask follows the visitor, so its new overloads are dispatched without changes of the subscription.
+     */
+    template <typename Visitor> static operation_mask make_visitor_mask()
+    {
+        return detail::visitor_mask<Visitor, operation>::get();
+    }
+
+    /**
+     * Call handler for operations of types in the mask.
+     */
+    void add(const operation_mask& mask, const handler_type& handler)
+    {
+        for (size_t tag = 0; tag < operation_count; ++tag)
+        {
+            if (mask.test(tag))
+                _handlers[tag].push_back(handler);
+        }
+    }
+
+    template <typename Operation, typename Handler> void add(Handler handler)
+    {
+        _handlers[operation::tag<Operation>::value].emplace_back(
+            [handler](const operation_notification& note) { handler(note.op.get<Operation>(), note); });
+    }
+
+    void operator()(const operation_notification& note) const
+    {
+        for (const handler_type& handler : _handlers[note.op.which()])
+        {
+            handler(note);
+        }
+    }
+
+private:
+    std::array<std::vector<handler_type>, operation_count> _handlers;
+};
+
+} // namespace chain
+} // namespace scorum
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <scorum/protocol/operations.hpp>
+
+#include <fc/reflect/reflect.hpp>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace scorum {
+namespace chain {
+
+using scorum::protocol::operation;
+
+struct operation_profile
+{
+    std::string name;
+    uint64_t count = 0;
+
+    /// evaluator time
+    uint64_t total_ns = 0;
+    uint64_t avg_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t max_ns = 0;
+
+    /// time spent in pre_apply_operation and post_apply_operation handlers (plugins)
+    uint64_t pre_notify_ns = 0;
+    uint64_t post_notify_ns = 0;
+};
+
+/**
+ *  Execution time of applied operations by operation type.
+ *
+ *  Latencies are kept in histograms with power of two buckets, p99 is reported as the upper bound of the bucket
+ *  it falls into. Nothing is measured while the profiler is disabled.
+ */
+class operation_profiler
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    void enable()
+    {
+        _enabled = true;
+    }
+
+    void disable()
+    {
+        _enabled = false;
+    }
+
+    bool enabled() const
+    {
+        return _enabled;
+    }
+
+    void record(const operation& op,
+                clock::duration pre_notify,
+                clock::duration evaluate,
+                clock::duration post_notify);
+
+    /**
+     * Profiles of applied operation types ordered by total time (evaluator and handlers) descending.
+     */
+    std::vector<operation_profile> get_profiles() const;
+
+    void reset();
+
+private:
+    static constexpr size_t histogram_size = 48;
+
+    struct counters
+    {
+        uint64_t count = 0;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        uint64_t pre_notify_ns = 0;
+        uint64_t post_notify_ns = 0;
+        std::array<uint64_t, histogram_size> histogram = {};
+    };
+
+    static uint64_t get_percentile(const counters& c, uint32_t percent);
+
+    bool _enabled = false;
+
+    // indexed by operation::which()
+    std::vector<counters> _counters;
+};
+
+} // namespace chain
+} // namespace scorum
+
+// clang-format off
+FC_REFLECT(scorum::chain::operation_profile,
+           (name)
+           (count)
+           (total_ns)
+           (avg_ns)
+           (p99_ns)
+           (max_ns)
+           (pre_notify_ns)
+           (post_notify_ns))
+// clang-format on
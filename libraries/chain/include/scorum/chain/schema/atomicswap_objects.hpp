@@ -63,6 +63,7 @@ public:
 struct by_owner_name;
 struct by_recipient_name;
 struct by_contract_hash;
+struct by_deadline;
 
 typedef multi_index_container<atomicswap_contract_object,
                               indexed_by<ordered_unique<tag<by_id>,
@@ -80,7 +81,18 @@ typedef multi_index_container<atomicswap_contract_object,
                                          ordered_unique<tag<by_contract_hash>,
                                                         member<atomicswap_contract_object,
                                                                hash_index_type,
-                                                               &atomicswap_contract_object::contract_hash>>>,
+                                                               &atomicswap_contract_object::contract_hash>>,
+                                         ordered_unique<tag<by_deadline>,
+                                                        composite_key<atomicswap_contract_object,
+                                                                      member<atomicswap_contract_object,
+                                                                             time_point_sec,
+                                                                             &atomicswap_contract_object::deadline>,
+                                                                      member<atomicswap_contract_object,
+                                                                             account_name_type,
+                                                                             &atomicswap_contract_object::owner>,
+                                                                      member<atomicswap_contract_object,
+                                                                             atomicswap_contract_id_type,
+                                                                             &atomicswap_contract_object::id>>>>,
                               allocator<atomicswap_contract_object>>
     atomicswap_contract_index;
 }
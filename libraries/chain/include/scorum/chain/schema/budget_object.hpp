@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fc/fixed_string.hpp>
+#include <fc/uint128.hpp>
 
 #include <scorum/protocol/authority.hpp>
 #include <scorum/protocol/scorum_operations.hpp>
@@ -11,6 +12,7 @@
 
 #include <boost/multi_index/composite_key.hpp>
 
+#include <limits>
 #include <numeric>
 
 namespace scorum {
@@ -41,20 +43,68 @@ public:
     asset balance = asset(0, SCORUM_SYMBOL);
     share_type per_block = 0;
 
+    /// balance and last_allocated_block are only updated when budget is created or closed,
+    /// per_block is allocated in every block after last_allocated_block while there is something left
     uint32_t last_allocated_block = 0;
+
+    /// balance left after allocations of all blocks up to block_num
+    asset balance_at(uint32_t block_num) const
+    {
+        if (block_num <= last_allocated_block)
+            return balance;
+
+        fc::uint128_t allocated = fc::uint128_t(per_block.value) * (block_num - last_allocated_block);
+        if (allocated >= fc::uint128_t(balance.amount.value))
+            return asset(0, SCORUM_SYMBOL);
+
+        return balance - asset((int64_t)allocated.to_uint64(), SCORUM_SYMBOL);
+    }
+
+    /// amount allocated in block block_num
+    asset allocation_at(uint32_t block_num) const
+    {
+        if (block_num <= last_allocated_block)
+            return asset(0, SCORUM_SYMBOL);
+
+        return balance_at(block_num - 1) - balance_at(block_num);
+    }
+
+    /// number of the block in which the rest of balance is allocated
+    uint32_t last_allocation_block() const
+    {
+        const uint64_t max_blocks = std::numeric_limits<uint32_t>::max() - last_allocated_block;
+        if (per_block <= 0)
+            return std::numeric_limits<uint32_t>::max();
+
+        uint64_t blocks = (uint64_t)((balance.amount + per_block - 1) / per_block).value;
+
+        return last_allocated_block + (uint32_t)std::min(blocks, max_blocks);
+    }
 };
 
 struct by_owner_name;
+struct by_last_allocation_block;
+struct by_deadline;
 
+// clang-format off
 typedef multi_index_container<budget_object,
                               indexed_by<ordered_unique<tag<by_id>,
                                                         member<budget_object, budget_id_type, &budget_object::id>>,
                                          ordered_non_unique<tag<by_owner_name>,
                                                             member<budget_object,
                                                                    account_name_type,
-                                                                   &budget_object::owner>>>,
+                                                                   &budget_object::owner>>,
+                                         ordered_unique<tag<by_last_allocation_block>,
+                                                        composite_key<budget_object,
+                                                                      const_mem_fun<budget_object, uint32_t, &budget_object::last_allocation_block>,
+                                                                      member<budget_object, budget_id_type, &budget_object::id>>>,
+                                         ordered_unique<tag<by_deadline>,
+                                                        composite_key<budget_object,
+                                                                      member<budget_object, time_point_sec, &budget_object::deadline>,
+                                                                      member<budget_object, budget_id_type, &budget_object::id>>>>,
                               allocator<budget_object>>
     budget_index;
+// clang-format on
 } // namespace chain
 } // namespace scorum
 
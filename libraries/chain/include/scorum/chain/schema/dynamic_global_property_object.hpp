@@ -44,6 +44,14 @@ public:
     asset total_supply = asset(0, SCORUM_SYMBOL); ///< accounts_current_supply + reward and registration pools supply
     asset accounts_current_supply = asset(0, SCORUM_SYMBOL); ///< total SCR on accounts balances
     asset total_vesting_shares = asset(0, VESTS_SYMBOL); ///< total SP on accounts vesting shares
+    asset budgets_per_block = asset(0, SCORUM_SYMBOL); ///< sum of per block allocations of all budgets
+
+    /// Running totals of SCR held by objects of each kind, maintained by services on every balance change
+    /// to check the supply invariant without scanning the objects.
+    asset total_accounts_balance = asset(0, SCORUM_SYMBOL); ///< SCR on accounts balances
+    asset total_escrow_balance = asset(0, SCORUM_SYMBOL); ///< SCR held by escrows, pending fees included
+    asset total_atomicswap_balance = asset(0, SCORUM_SYMBOL); ///< SCR locked in atomic swap contracts
+    asset total_budgets_balance = asset(0, SCORUM_SYMBOL); ///< SCR left in budgets
 
     price get_vesting_share_price() const
     {
@@ -107,6 +115,11 @@ FC_REFLECT(scorum::chain::dynamic_global_property_object,
           (total_supply)
           (accounts_current_supply)
           (total_vesting_shares)
+          (budgets_per_block)
+          (total_accounts_balance)
+          (total_escrow_balance)
+          (total_atomicswap_balance)
+          (total_budgets_balance)
           (maximum_block_size)
           (current_aslot)
           (recent_slots_filled)
@@ -8,12 +8,12 @@
 namespace scorum {
 namespace chain {
 
-using scorum::protocol::signed_transaction;
-
 /**
  * The purpose of this object is to enable the detection of duplicate transactions. When a transaction is included
  * in a block a transaction_object is added. At the end of block processing all transaction_objects that have
  * expired can be removed from the index.
+ *
+ * Transaction bodies are not stored, a recent transaction is read from the block it was included in.
  */
 class transaction_object : public object<transaction_object_type, transaction_object>
 {
@@ -22,16 +22,17 @@ class transaction_object : public object<transaction_object_type, transaction_ob
 public:
     template <typename Constructor, typename Allocator>
     transaction_object(Constructor&& c, allocator<Allocator> a)
-        : packed_trx(a)
     {
         c(*this);
     }
 
     id_type id;
 
-    bip::vector<char, allocator<char>> packed_trx;
     transaction_id_type trx_id;
     time_point_sec expiration;
+
+    /// number of the block the transaction is included in
+    uint32_t block_num = 0;
 };
 
 struct by_expiration;
@@ -54,5 +55,5 @@ typedef multi_index_container<transaction_object,
 }
 } // scorum::chain
 
-FC_REFLECT(scorum::chain::transaction_object, (id)(packed_trx)(trx_id)(expiration))
+FC_REFLECT(scorum::chain::transaction_object, (id)(trx_id)(expiration)(block_num))
 CHAINBASE_SET_INDEX_TYPE(scorum::chain::transaction_object, scorum::chain::transaction_index)
@@ -32,7 +32,7 @@ struct atomicswap_service_i
 
     virtual void redeem_contract(const atomicswap_contract_object& contract, const std::string& secret) = 0;
     virtual void refund_contract(const atomicswap_contract_object& contract) = 0;
-    virtual void check_contracts_expiration() = 0;
+    virtual void expire_contract(const atomicswap_contract_object& contract) = 0;
 };
 
 /**
@@ -63,10 +63,11 @@ public:
 
     virtual void refund_contract(const atomicswap_contract_object& contract) override;
 
-    virtual void check_contracts_expiration() override;
+    virtual void expire_contract(const atomicswap_contract_object& contract) override;
 
 private:
     std::size_t _contracts_per_recipient(const account_name_type& owner, const account_name_type& recipient) const;
+    void _adjust_total_balance(const asset& delta);
 };
 } // namespace chain
 } // namespace scorum
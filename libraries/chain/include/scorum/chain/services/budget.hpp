@@ -29,7 +29,8 @@ struct budget_service_i
         = 0;
 
     virtual void close_budget(const budget_object& budget) = 0;
-    virtual asset allocate_cash(const budget_object& budget) = 0;
+    virtual asset get_balance(const budget_object& budget) const = 0;
+    virtual asset allocate_cash() = 0;
 };
 
 /**
@@ -106,22 +107,30 @@ public:
      */
     virtual void close_budget(const budget_object& budget);
 
-    /** Distributes asset from budget.
-     *  This operation takes into account the deadline and last block number
+    /** Gets budget balance left after allocations up to the head block.
+     *  Budget objects are not updated on every allocation, the stored balance is
+     *  the one budget had at last_allocated_block.
      *
-     * @param budget the budget that is distributed
+     * @param budget the budget
      */
-    virtual asset allocate_cash(const budget_object& budget) override;
+    virtual asset get_balance(const budget_object& budget) const override;
+
+    /** Distributes asset from all budgets for the head block.
+     *  Only budgets which allocate the rest of balance or reach deadline in this block are modified,
+     *  the others contribute their per_block through the aggregate in dynamic global properties.
+     *
+     * @returns the total amount allocated in this block
+     */
+    virtual asset allocate_cash() override;
 
 private:
     share_type
     _calculate_per_block(const time_point_sec& start_date, const time_point_sec& end_date, share_type balance_amount);
-    asset _decrease_balance(const budget_object&, const asset& balance);
-    bool _check_autoclose(const budget_object&);
     bool _is_fund_budget(const budget_object&) const;
     void _close_budget(const budget_object&);
     void _close_owned_budget(const budget_object&);
     void _close_fund_budget(const budget_object&);
+    void _remove_budget(const budget_object&);
     uint64_t _get_budget_count(const account_name_type& owner) const;
 };
 } // namespace chain
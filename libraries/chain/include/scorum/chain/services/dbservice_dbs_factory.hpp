@@ -4,6 +4,7 @@
 #include <map>
 #include <string>
 #include <typeinfo>
+#include <vector>
 
 #include <boost/config.hpp>
 #include <boost/type_index.hpp>
@@ -14,6 +15,12 @@ namespace chain {
 class database;
 class dbs_base;
 
+/**
+ *  Owner of service instances, a service is created on first use.
+ *
+ *  Every service type gets a slot number once per process, so obtaining a service is an index into a vector
+ *  instead of a lookup by type.
+ */
 class dbservice_dbs_factory
 {
     using BaseServicePtr = std::unique_ptr<dbs_base>;
@@ -28,20 +35,31 @@ protected:
 public:
     template <typename ConcreteService> ConcreteService& obtain_service() const
     {
-        auto it = _dbs.find(boost::typeindex::type_id<ConcreteService>());
-        if (it == _dbs.end())
+        const size_t slot = get_service_slot<ConcreteService>();
+        if (slot >= _dbs.size())
         {
-            it = _dbs.insert(std::make_pair(boost::typeindex::type_id<ConcreteService>(),
-                                            BaseServicePtr(new ConcreteService(_db_core))))
-                     .first;
+            _dbs.resize(slot + 1);
+        }
+
+        BaseServicePtr& ret = _dbs[slot];
+        if (!ret)
+        {
+            ret.reset(new ConcreteService(_db_core));
         }
 
-        BaseServicePtr& ret = it->second;
         return static_cast<ConcreteService&>(*ret);
     }
 
 private:
-    mutable std::map<boost::typeindex::type_index, BaseServicePtr> _dbs;
+    static size_t get_next_service_slot();
+
+    template <typename ConcreteService> static size_t get_service_slot()
+    {
+        static const size_t slot = get_next_service_slot();
+        return slot;
+    }
+
+    mutable std::vector<BaseServicePtr> _dbs;
     database& _db_core;
 };
 } // namespace chain
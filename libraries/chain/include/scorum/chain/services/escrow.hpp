@@ -52,6 +52,9 @@ public:
     void update(const escrow_object& escrow, const modifier_type& modifier) override;
 
     void remove(const escrow_object& escrow) override;
+
+private:
+    void _adjust_total_balance(const asset& delta);
 };
 } // namespace chain
 } // namespace scorum
@@ -31,8 +31,6 @@ struct proposal_service_i
 
     virtual bool is_expired(const proposal_object& proposal) = 0;
 
-    virtual void clear_expired_proposals() = 0;
-
     virtual void for_all_proposals_remove_from_voting_list(const account_name_type& member) = 0;
 
     using proposal_refs_type = std::vector<proposal_object::cref_type>;
@@ -66,8 +64,6 @@ public:
 
     bool is_expired(const proposal_object& proposal) override;
 
-    void clear_expired_proposals() override;
-
     void for_all_proposals_remove_from_voting_list(const account_name_type& member) override;
 
     proposal_refs_type get_proposals() override;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace scorum {
+namespace chain {
+namespace util {
+
+/**
+ * Run task(i) for i in [0, count) on up to threads threads (zero means all cores),
+ * the first exception thrown by a task is rethrown after all threads are joined.
+ */
+void parallel_for(size_t count, uint32_t threads, const std::function<void(size_t)>& task);
+}
+}
+} // scorum::chain::util
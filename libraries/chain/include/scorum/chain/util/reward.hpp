@@ -11,6 +11,8 @@
 
 #include <fc/uint128.hpp>
 
+#include <vector>
+
 namespace scorum {
 namespace chain {
 namespace util {
@@ -35,6 +37,46 @@ uint64_t get_rshare_reward(const comment_reward_context& ctx);
 
 uint128_t evaluate_reward_curve(const uint128_t& rshares, const curve_id& curve = quadratic);
 
+/**
+ *  Rewards of the comments cashed out in one block.
+ *
+ *  Comment parameters are copied to parallel arrays, so the reward curve and the payouts are evaluated
+ *  in flat loops without touching comment objects. Payouts are the same as get_rshare_reward returns
+ *  for each comment with the same fund state.
+ */
+struct comment_reward_batch
+{
+    void reserve(size_t n);
+
+    /**
+     * Add comment, non-positive rshares are not rewarded.
+     */
+    void push_back(const share_type& rshares, uint16_t reward_weight, const asset& max_scr);
+
+    size_t size() const
+    {
+        return rshares.size();
+    }
+
+    /**
+     * Evaluate reward curve of all comments.
+     * @return sum of claims
+     */
+    uint128_t evaluate_claims(const curve_id& curve);
+
+    /**
+     * Evaluate payouts of all comments, claims have to be evaluated first.
+     */
+    void evaluate_payouts(const uint128_t& total_reward_shares2, const asset& total_reward_fund_scorum);
+
+    std::vector<uint64_t> rshares;
+    std::vector<uint16_t> reward_weights;
+    std::vector<share_type> max_scr;
+
+    std::vector<uint128_t> claims;
+    std::vector<share_type> payouts;
+};
+
 // SCORUM: decide who will we approach MIN PAYOUT if we don't have stable coin
 inline bool is_comment_payout_dust(uint64_t scorum_payout)
 {
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <fc/static_variant.hpp>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace scorum {
+namespace chain {
+namespace util {
+
+/**
+ * Number of types of a static_variant known at compile time, to size tables indexed by which().
+ */
+template <typename Variant> struct static_variant_size;
+
+template <typename... Types>
+struct static_variant_size<fc::static_variant<Types...>> : std::integral_constant<size_t, sizeof...(Types)>
+{
+};
+}
+}
+} // scorum::chain::util
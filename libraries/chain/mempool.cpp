@@ -0,0 +1,202 @@
+#include <scorum/chain/mempool.hpp>
+
+#include <scorum/protocol/operations.hpp>
+
+#include <fc/io/raw.hpp>
+
+namespace scorum {
+namespace chain {
+
+pending_transaction::pending_transaction(const signed_transaction& t)
+    : trx(t)
+    , id(t.id())
+    , expiration(t.expiration)
+    , size((uint32_t)fc::raw::pack_size(t))
+{
+}
+
+bool pending_transaction::depends_on(const fc::flat_set<account_name_type>& accounts) const
+{
+    for (const auto& name : accounts)
+    {
+        if (authority_accounts.find(name) != authority_accounts.end())
+            return true;
+    }
+
+    return false;
+}
+
+bool mempool::contains(const transaction_id_type& id) const
+{
+    const auto& idx = _transactions.get<by_id>();
+    return idx.find(id) != idx.end();
+}
+
+const pending_transaction* mempool::find(const transaction_id_type& id) const
+{
+    const auto& idx = _transactions.get<by_id>();
+    auto it = idx.find(id);
+    return it != idx.end() ? &(*it) : nullptr;
+}
+
+const pending_transaction& mempool::push(pending_transaction&& ptx)
+{
+    auto result = _transactions.push_back(std::move(ptx));
+    const pending_transaction& added = *result.first;
+    if (!result.second)
+        return added;
+
+    for (const auto& name : added.authority_accounts)
+    {
+        _by_account.emplace(name, added.id);
+    }
+
+    _total_size += added.size;
+
+    return added;
+}
+
+void mempool::clear()
+{
+    _transactions.clear();
+    _by_account.clear();
+    _total_size = 0;
+}
+
+void mempool::swap(mempool& other)
+{
+    _transactions.swap(other._transactions);
+    _by_account.swap(other._by_account);
+    std::swap(_total_size, other._total_size);
+}
+
+uint32_t mempool::remove_expired(fc::time_point_sec now)
+{
+    auto& idx = _transactions.get<by_expiration>();
+
+    uint32_t removed = 0;
+    fc::flat_set<account_name_type> updates;
+    auto it = idx.begin();
+    while (it != idx.end() && it->expiration < now)
+    {
+        auto trx_updates = get_authority_updates(it->trx);
+        updates.insert(trx_updates.begin(), trx_updates.end());
+
+        _erase_accounts(*it);
+        _total_size -= it->size;
+        it = idx.erase(it);
+        ++removed;
+    }
+
+    invalidate(updates);
+
+    return removed;
+}
+
+void mempool::invalidate(const fc::flat_set<account_name_type>& accounts)
+{
+    auto& idx = _transactions.get<by_id>();
+
+    for (const auto& name : accounts)
+    {
+        auto range = _by_account.equal_range(name);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            auto tx_it = idx.find(it->second);
+            if (tx_it != idx.end())
+            {
+                idx.modify(tx_it, [](pending_transaction& ptx) { ptx.verified = false; });
+            }
+        }
+    }
+}
+
+void mempool::invalidate_all()
+{
+    for (auto it = _transactions.begin(); it != _transactions.end(); ++it)
+    {
+        _transactions.modify(it, [](pending_transaction& ptx) { ptx.verified = false; });
+    }
+}
+
+void mempool::record_reapply(uint32_t reapplied, uint32_t revalidated, uint32_t dropped, const fc::microseconds& time)
+{
+    _stats.reapplied += reapplied;
+    _stats.revalidated += revalidated;
+    _stats.dropped += dropped;
+    _stats.last_reapply_time_us = time.count();
+    _stats.total_reapply_time_us += time.count();
+}
+
+mempool_stats mempool::get_stats() const
+{
+    mempool_stats stats = _stats;
+    stats.pending = (uint32_t)_transactions.size();
+    stats.pending_size = _total_size;
+    return stats;
+}
+
+fc::flat_set<account_name_type> mempool::get_authority_updates(const signed_transaction& trx)
+{
+    using namespace scorum::protocol;
+
+    fc::flat_set<account_name_type> accounts;
+
+    for (const auto& op : trx.operations)
+    {
+        switch (op.which())
+        {
+        case operation::tag<account_update_operation>::value:
+            accounts.insert(op.get<account_update_operation>().account);
+            break;
+        case operation::tag<recover_account_operation>::value:
+            accounts.insert(op.get<recover_account_operation>().account_to_recover);
+            break;
+        case operation::tag<account_create_operation>::value:
+            accounts.insert(op.get<account_create_operation>().new_account_name);
+            break;
+        case operation::tag<account_create_with_delegation_operation>::value:
+            accounts.insert(op.get<account_create_with_delegation_operation>().new_account_name);
+            break;
+        case operation::tag<account_create_by_committee_operation>::value:
+            accounts.insert(op.get<account_create_by_committee_operation>().new_account_name);
+            break;
+        default:
+            break;
+        }
+    }
+
+    return accounts;
+}
+
+fc::flat_set<account_name_type> mempool::get_authority_updates(const signed_block& b)
+{
+    fc::flat_set<account_name_type> accounts;
+
+    for (const auto& trx : b.transactions)
+    {
+        auto trx_accounts = get_authority_updates(trx);
+        accounts.insert(trx_accounts.begin(), trx_accounts.end());
+    }
+
+    return accounts;
+}
+
+void mempool::_erase_accounts(const pending_transaction& ptx)
+{
+    for (const auto& name : ptx.authority_accounts)
+    {
+        auto range = _by_account.equal_range(name);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == ptx.id)
+            {
+                _by_account.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+} // namespace chain
+} // namespace scorum
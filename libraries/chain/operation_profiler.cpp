@@ -0,0 +1,106 @@
+#include <scorum/chain/operation_profiler.hpp>
+
+#include <scorum/protocol/operation_util_impl.hpp>
+
+#include <algorithm>
+
+namespace scorum {
+namespace chain {
+
+namespace {
+
+uint64_t to_ns(operation_profiler::clock::duration d)
+{
+    return (uint64_t)std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(), 0);
+}
+
+// bucket i keeps times in [2^(i-1), 2^i) nanoseconds
+size_t get_bucket(uint64_t ns)
+{
+    size_t bucket = 0;
+    while (ns != 0)
+    {
+        ns >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+}
+
+void operation_profiler::record(const operation& op,
+                                clock::duration pre_notify,
+                                clock::duration evaluate,
+                                clock::duration post_notify)
+{
+    const size_t which = (size_t)op.which();
+    if (which >= _counters.size())
+        _counters.resize(operation::count());
+
+    const uint64_t evaluate_ns = to_ns(evaluate);
+
+    counters& c = _counters[which];
+    ++c.count;
+    c.total_ns += evaluate_ns;
+    c.max_ns = std::max(c.max_ns, evaluate_ns);
+    c.pre_notify_ns += to_ns(pre_notify);
+    c.post_notify_ns += to_ns(post_notify);
+    ++c.histogram[std::min(get_bucket(evaluate_ns), histogram_size - 1)];
+}
+
+uint64_t operation_profiler::get_percentile(const counters& c, uint32_t percent)
+{
+    const uint64_t rank = (c.count * percent + 99) / 100;
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < histogram_size; ++bucket)
+    {
+        seen += c.histogram[bucket];
+        if (seen >= rank)
+            return bucket == 0 ? 0 : std::min((uint64_t)1 << bucket, c.max_ns);
+    }
+
+    return c.max_ns;
+}
+
+std::vector<operation_profile> operation_profiler::get_profiles() const
+{
+    std::vector<operation_profile> result;
+
+    for (size_t which = 0; which < _counters.size(); ++which)
+    {
+        const counters& c = _counters[which];
+        if (c.count == 0)
+            continue;
+
+        operation_profile profile;
+
+        operation op;
+        op.set_which(which);
+        op.visit(fc::get_operation_name(profile.name));
+
+        profile.count = c.count;
+        profile.total_ns = c.total_ns;
+        profile.avg_ns = c.total_ns / c.count;
+        profile.p99_ns = get_percentile(c, 99);
+        profile.max_ns = c.max_ns;
+        profile.pre_notify_ns = c.pre_notify_ns;
+        profile.post_notify_ns = c.post_notify_ns;
+
+        result.push_back(std::move(profile));
+    }
+
+    std::sort(result.begin(), result.end(), [](const operation_profile& lhs, const operation_profile& rhs) {
+        return lhs.total_ns + lhs.pre_notify_ns + lhs.post_notify_ns
+            > rhs.total_ns + rhs.pre_notify_ns + rhs.post_notify_ns;
+    });
+
+    return result;
+}
+
+void operation_profiler::reset()
+{
+    _counters.clear();
+}
+
+} // namespace chain
+} // namespace scorum
@@ -80,10 +80,9 @@ const account_object& dbs_account::create_initial_account(const account_name_typ
     const auto& new_account
         = _create_account_objects(new_account_name, recovery_account, memo_key, json_metadata, owner, owner, owner);
 
-    db_impl().modify(new_account, [&](account_object& acc) {
-        acc.created_by_genesis = true;
-        acc.balance = balance;
-    });
+    db_impl().modify(new_account, [&](account_object& acc) { acc.created_by_genesis = true; });
+
+    increase_balance(new_account, balance);
 
     return new_account;
 }
@@ -101,7 +100,7 @@ const account_object& dbs_account::create_account(const account_name_type& new_a
 
     const auto& creator = get_account(creator_name);
 
-    db_impl().modify(creator, [&](account_object& c) { c.balance -= fee; });
+    decrease_balance(creator, fee);
 
     const auto& new_account
         = _create_account_objects(new_account_name, creator_name, memo_key, json_metadata, owner, active, posting);
@@ -126,10 +125,8 @@ const account_object& dbs_account::create_account_with_delegation(const account_
 
     const auto& creator = get_account(creator_name);
 
-    db_impl().modify(creator, [&](account_object& c) {
-        c.balance -= fee;
-        c.delegated_vesting_shares += delegation;
-    });
+    decrease_balance(creator, fee);
+    db_impl().modify(creator, [&](account_object& c) { c.delegated_vesting_shares += delegation; });
 
     const auto& new_account
         = _create_account_objects(new_account_name, creator_name, memo_key, json_metadata, owner, active, posting);
@@ -239,6 +236,8 @@ void dbs_account::increase_balance(const account_object& account, const asset& s
 {
     FC_ASSERT(scorums.symbol == SCORUM_SYMBOL, "invalid asset type (symbol)");
     db_impl().modify(account, [&](account_object& acnt) { acnt.balance += scorums; });
+    db_impl().modify(db_impl().get_dynamic_global_properties(),
+                     [&](dynamic_global_property_object& props) { props.total_accounts_balance += scorums; });
 }
 
 void dbs_account::decrease_balance(const account_object& account, const asset& scorums)
@@ -4,6 +4,7 @@
 
 #include <scorum/chain/schema/account_objects.hpp>
 #include <scorum/chain/schema/atomicswap_objects.hpp>
+#include <scorum/chain/schema/dynamic_global_property_object.hpp>
 
 #include <scorum/protocol/atomicswap_helper.hpp>
 
@@ -104,6 +105,8 @@ const atomicswap_contract_object& dbs_atomicswap::create_contract(atomicswap_con
     dbs_account& account_service = db().obtain_service<dbs_account>();
     account_service.decrease_balance(owner, amount);
 
+    _adjust_total_balance(amount);
+
     return new_contract;
 }
 
@@ -115,6 +118,8 @@ void dbs_atomicswap::redeem_contract(const atomicswap_contract_object& contract,
 
     account_service.increase_balance(to, contract.amount);
 
+    _adjust_total_balance(-contract.amount);
+
     if (contract.type == atomicswap_contract_initiator)
     {
         db_impl().remove(contract);
@@ -137,38 +142,30 @@ void dbs_atomicswap::refund_contract(const atomicswap_contract_object& contract)
 
     account_service.increase_balance(owner, contract.amount);
 
+    _adjust_total_balance(-contract.amount);
+
     db_impl().remove(contract);
 }
 
-void dbs_atomicswap::check_contracts_expiration()
+void dbs_atomicswap::expire_contract(const atomicswap_contract_object& contract)
 {
-    atomicswap_contracts_refs_type contracts;
-
-    const auto& idx = db_impl().get_index<atomicswap_contract_index>().indices().get<by_owner_name>();
-    for (auto it = idx.cbegin(); it != idx.cend(); ++it)
+    if (contract.secret.empty())
     {
-        contracts.push_back(std::cref(*it));
+        // only for initiator or not redeemed participant contracts
+        refund_contract(contract);
     }
-
-    const dynamic_global_property_object& props = db_impl().get_dynamic_global_properties();
-
-    for (const atomicswap_contract_object& contract : contracts)
+    else
     {
-        if (props.time >= contract.deadline)
-        {
-            if (contract.secret.empty())
-            {
-                // only for initiator or not redeemed participant contracts
-                refund_contract(contract);
-            }
-            else
-            {
-                db_impl().remove(contract);
-            }
-        }
+        db_impl().remove(contract);
     }
 }
 
+void dbs_atomicswap::_adjust_total_balance(const asset& delta)
+{
+    db_impl().modify(db_impl().get_dynamic_global_properties(),
+                     [&](dynamic_global_property_object& props) { props.total_atomicswap_balance += delta; });
+}
+
 std::size_t dbs_atomicswap::_contracts_per_recipient(const account_name_type& owner,
                                                      const account_name_type& recipient) const
 {
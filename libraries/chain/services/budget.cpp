@@ -4,6 +4,7 @@
 
 #include <scorum/chain/schema/account_objects.hpp>
 #include <scorum/chain/schema/budget_object.hpp>
+#include <scorum/chain/schema/dynamic_global_property_object.hpp>
 
 #include <tuple>
 
@@ -117,6 +118,11 @@ const budget_object& dbs_budget::create_fund_budget(const asset& balance, const
         budget.last_allocated_block = head_block_num;
     });
 
+    db_impl().modify(props, [&](dynamic_global_property_object& p) {
+        p.budgets_per_block += asset(per_block, SCORUM_SYMBOL);
+        p.total_budgets_balance += balance;
+    });
+
     // there are not schedules for genesis budget
     return new_budget;
 }
@@ -161,6 +167,11 @@ const budget_object& dbs_budget::create_budget(const account_object& owner,
         budget.last_allocated_block = head_block_num;
     });
 
+    db_impl().modify(props, [&](dynamic_global_property_object& p) {
+        p.budgets_per_block += asset(per_block, SCORUM_SYMBOL);
+        p.total_budgets_balance += balance;
+    });
+
     return new_budget;
 }
 
@@ -171,38 +182,53 @@ void dbs_budget::close_budget(const budget_object& budget)
     _close_owned_budget(budget);
 }
 
-asset dbs_budget::allocate_cash(const budget_object& budget)
+asset dbs_budget::get_balance(const budget_object& budget) const
 {
-    asset ret(0, SCORUM_SYMBOL);
+    return budget.balance_at(db_impl().head_block_num());
+}
 
-    time_point_sec t = db_impl().head_block_time();
-    auto head_block_num = db_impl().head_block_num();
+asset dbs_budget::allocate_cash()
+{
+    const dynamic_global_property_object& props = db_impl().get_dynamic_global_properties();
+
+    time_point_sec t = props.time;
+    auto head_block_num = props.head_block_number;
 
-    if (budget.last_allocated_block >= head_block_num)
+    // every budget allocates per_block in this block except the ones that have less left
+    asset ret = props.budgets_per_block;
+
+    const auto& budgets_by_last_allocation
+        = db_impl().get_index<budget_index>().indices().get<by_last_allocation_block>();
+    while (!budgets_by_last_allocation.empty()
+           && budgets_by_last_allocation.begin()->last_allocation_block() <= head_block_num)
     {
-        return ret; // empty (allocation waits new block)
-    }
+        const budget_object& budget = *budgets_by_last_allocation.begin();
 
-    FC_ASSERT(budget.per_block > 0, "Invalid per_block.");
-    ret = _decrease_balance(budget, asset(budget.per_block, SCORUM_SYMBOL));
+        ret -= asset(budget.per_block, SCORUM_SYMBOL);
+        ret += budget.allocation_at(head_block_num);
+
+        _close_budget(budget);
+    }
 
-    if (budget.deadline <= t)
+    const auto& budgets_by_deadline = db_impl().get_index<budget_index>().indices().get<by_deadline>();
+    while (!budgets_by_deadline.empty() && budgets_by_deadline.begin()->deadline <= t)
     {
+        const budget_object& budget = *budgets_by_deadline.begin();
+
+        ret -= asset(budget.per_block, SCORUM_SYMBOL);
+        ret += budget.allocation_at(head_block_num);
+
         if (_is_fund_budget(budget))
         {
             // cash back from budget to requesting beneficiary
             // to save from burning (no owner for fund budget)
-            ret.amount += budget.balance.amount;
+            ret += budget.balance_at(head_block_num);
         }
         _close_budget(budget);
     }
-    else
-    {
-        if (!_check_autoclose(budget))
-        {
-            db_impl().modify(budget, [&](budget_object& b) { b.last_allocated_block = head_block_num; });
-        }
-    }
+
+    db_impl().modify(props, [&](dynamic_global_property_object& p) { p.total_budgets_balance -= ret; });
+
     return ret;
 }
 
@@ -231,42 +257,6 @@ share_type dbs_budget::_calculate_per_block(const time_point_sec& start_date,
     return ret;
 }
 
-asset dbs_budget::_decrease_balance(const budget_object& budget, const asset& balance)
-{
-    FC_ASSERT(balance.symbol == SCORUM_SYMBOL, "Invalid asset type (symbol).");
-    FC_ASSERT(balance.amount > 0, "Invalid balance.");
-
-    asset ret(0, SCORUM_SYMBOL);
-
-    db_impl().modify(budget, [&](budget_object& b) {
-        if (b.balance.amount > 0 && balance.amount <= b.balance.amount)
-        {
-            b.balance -= balance;
-            ret = balance;
-        }
-        else
-        {
-            ret = b.balance;
-            b.balance.amount = 0;
-        }
-    });
-
-    return ret;
-}
-
-bool dbs_budget::_check_autoclose(const budget_object& budget)
-{
-    if (budget.balance.amount <= 0)
-    {
-        _close_budget(budget);
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-}
-
 bool dbs_budget::_is_fund_budget(const budget_object& budget) const
 {
     return budget.owner == SCORUM_ROOT_POST_PARENT;
@@ -294,22 +284,31 @@ void dbs_budget::_close_owned_budget(const budget_object& budget)
 
     // withdraw all balance rest asset back to owner
     //
-    asset repayable = budget.balance;
+    asset repayable = get_balance(budget);
     if (repayable.amount > 0)
     {
-        repayable = _decrease_balance(budget, repayable);
         account_service.increase_balance(owner, repayable);
+
+        db_impl().modify(db_impl().get_dynamic_global_properties(),
+                         [&](dynamic_global_property_object& props) { props.total_budgets_balance -= repayable; });
     }
 
-    // delete budget
-    //
-    db_impl().remove(budget);
+    _remove_budget(budget);
 }
 
 void dbs_budget::_close_fund_budget(const budget_object& budget)
 {
     FC_ASSERT(_is_fund_budget(budget), "Not allowed for ordinary budget.");
 
+    _remove_budget(budget);
+}
+
+void dbs_budget::_remove_budget(const budget_object& budget)
+{
+    db_impl().modify(db_impl().get_dynamic_global_properties(), [&](dynamic_global_property_object& props) {
+        props.budgets_per_block -= asset(budget.per_block, SCORUM_SYMBOL);
+    });
+
     // delete budget
     //
     db_impl().remove(budget);
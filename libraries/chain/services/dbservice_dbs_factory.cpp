@@ -2,6 +2,8 @@
 #include <scorum/chain/services/dbs_base.hpp>
 #include <scorum/chain/database.hpp>
 
+#include <atomic>
+
 namespace scorum {
 namespace chain {
 
@@ -15,5 +17,11 @@ dbservice_dbs_factory::dbservice_dbs_factory(database& db)
 dbservice_dbs_factory::~dbservice_dbs_factory()
 {
 }
+
+size_t dbservice_dbs_factory::get_next_service_slot()
+{
+    static std::atomic<size_t> next_slot(0);
+    return next_slot++;
+}
 }
 }
@@ -2,6 +2,7 @@
 #include <scorum/chain/database.hpp>
 
 #include <scorum/chain/schema/scorum_objects.hpp>
+#include <scorum/chain/schema/dynamic_global_property_object.hpp>
 
 #include <tuple>
 
@@ -44,18 +45,35 @@ const escrow_object& dbs_escrow::create(uint32_t escrow_id,
         esc.pending_fee = pending_fee;
     });
 
+    _adjust_total_balance(scorum_amount + pending_fee);
+
     return new_escrow;
 }
 
 void dbs_escrow::update(const escrow_object& escrow, const modifier_type& modifier)
 {
+    const asset balance_before = escrow.scorum_balance + escrow.pending_fee;
+
     db_impl().modify(escrow, [&](escrow_object& e) { modifier(e); });
+
+    _adjust_total_balance(escrow.scorum_balance + escrow.pending_fee - balance_before);
 }
 
 void dbs_escrow::remove(const escrow_object& escrow)
 {
+    _adjust_total_balance(-(escrow.scorum_balance + escrow.pending_fee));
+
     db_impl().remove(escrow);
 }
 
+void dbs_escrow::_adjust_total_balance(const asset& delta)
+{
+    if (delta.amount == 0)
+        return;
+
+    db_impl().modify(db_impl().get_dynamic_global_properties(),
+                     [&](dynamic_global_property_object& props) { props.total_escrow_balance += delta; });
+}
+
 } // namespace chain
 } // namespace scorum
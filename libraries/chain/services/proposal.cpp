@@ -59,16 +59,6 @@ bool dbs_proposal::is_expired(const proposal_object& proposal)
     return (head_block_time() > proposal.expiration) ? true : false;
 }
 
-void dbs_proposal::clear_expired_proposals()
-{
-    const auto& proposal_expiration_index = db_impl().get_index<proposal_object_index>().indices().get<by_expiration>();
-
-    while (!proposal_expiration_index.empty() && is_expired(*proposal_expiration_index.begin()))
-    {
-        db_impl().remove(*proposal_expiration_index.begin());
-    }
-}
-
 void dbs_proposal::for_all_proposals_remove_from_voting_list(const account_name_type& member)
 {
     auto& proposals = db_impl().get_index<proposal_object_index>().indices().get<by_id>();
@@ -0,0 +1,57 @@
+#include <scorum/chain/util/parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace scorum {
+namespace chain {
+namespace util {
+
+void parallel_for(size_t count, uint32_t threads, const std::function<void(size_t)>& task)
+{
+    std::atomic<size_t> next(0);
+    std::vector<std::exception_ptr> errors(count);
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++)
+        {
+            try
+            {
+                task(i);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    size_t pool_size = std::min<size_t>(count, threads);
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < pool_size; ++i)
+    {
+        pool.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& t : pool)
+    {
+        t.join();
+    }
+
+    for (const auto& e : errors)
+    {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+}
+}
+} // scorum::chain::util
@@ -37,6 +37,31 @@ uint64_t approx_sqrt(const uint128_t& x)
     return result;
 }
 
+namespace {
+
+uint64_t get_payout(const uint128_t& claim, uint16_t reward_weight, uint64_t reward_fund, const uint128_t& total_claims)
+{
+    const uint64_t max_payout = uint64_t(std::numeric_limits<int64_t>::max());
+
+    // 128-bit math is exact while the products fit, larger claims take the 256-bit path of get_rshare_reward
+    if (claim.hi < (uint64_t(1) << 32))
+    {
+        uint128_t weighted_claim = (claim * uint128_t(reward_weight)) / SCORUM_100_PERCENT;
+        if (weighted_claim.hi == 0)
+        {
+            uint128_t payout = (uint128_t(reward_fund) * weighted_claim.lo) / total_claims;
+            FC_ASSERT(payout.hi == 0 && payout.lo <= max_payout);
+            return payout.lo;
+        }
+    }
+
+    u256 weighted_claim = (to256(claim) * reward_weight) / SCORUM_100_PERCENT;
+    u256 payout_u256 = (u256(reward_fund) * weighted_claim) / to256(total_claims);
+    FC_ASSERT(payout_u256 <= u256(max_payout));
+    return static_cast<uint64_t>(payout_u256);
+}
+}
+
 uint64_t get_rshare_reward(const comment_reward_context& ctx)
 {
     try
@@ -90,6 +115,94 @@ uint128_t evaluate_reward_curve(const uint128_t& rshares, const curve_id& curve)
 
     return result;
 }
+
+void comment_reward_batch::reserve(size_t n)
+{
+    rshares.reserve(n);
+    reward_weights.reserve(n);
+    max_scr.reserve(n);
+}
+
+void comment_reward_batch::push_back(const share_type& comment_rshares, uint16_t reward_weight, const asset& max_payout)
+{
+    rshares.push_back(comment_rshares > 0 ? uint64_t(comment_rshares.value) : 0);
+    reward_weights.push_back(reward_weight);
+    max_scr.push_back(max_payout.amount);
+}
+
+uint128_t comment_reward_batch::evaluate_claims(const curve_id& curve)
+{
+    const size_t n = size();
+    claims.resize(n);
+
+    // curve is chosen once for the whole batch, each loop body is branch free
+    switch (curve)
+    {
+    case quadratic:
+        for (size_t i = 0; i < n; ++i)
+        {
+            claims[i] = uint128_t(rshares[i]) * rshares[i];
+        }
+        break;
+    case linear:
+        for (size_t i = 0; i < n; ++i)
+        {
+            claims[i] = rshares[i];
+        }
+        break;
+    case square_root:
+        for (size_t i = 0; i < n; ++i)
+        {
+            claims[i] = approx_sqrt(rshares[i]);
+        }
+        break;
+    case power1dot5:
+        for (size_t i = 0; i < n; ++i)
+        {
+            claims[i] = approx_sqrt(uint128_t(rshares[i]) * rshares[i] * rshares[i]);
+        }
+        break;
+    }
+
+    uint128_t total_claims = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        total_claims += claims[i];
+    }
+
+    return total_claims;
+}
+
+void comment_reward_batch::evaluate_payouts(const uint128_t& total_reward_shares2, const asset& total_reward_fund_scorum)
+{
+    try
+    {
+        const size_t n = size();
+        FC_ASSERT(claims.size() == n, "Claims are not evaluated.");
+
+        FC_ASSERT(total_reward_fund_scorum.amount >= 0);
+
+        payouts.assign(n, 0);
+
+        const uint64_t reward_fund = uint64_t(total_reward_fund_scorum.amount.value);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (rshares[i] == 0)
+                continue;
+
+            FC_ASSERT(total_reward_shares2 > 0);
+
+            uint64_t payout = get_payout(claims[i], reward_weights[i], reward_fund, total_reward_shares2);
+
+            if (is_comment_payout_dust(payout))
+                payout = 0;
+
+            payouts[i] = std::min(payout, uint64_t(max_scr[i].value));
+        }
+    }
+    FC_CAPTURE_AND_RETHROW((total_reward_shares2)(total_reward_fund_scorum))
+}
 }
 }
 } // scorum::chain::util
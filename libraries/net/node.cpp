@@ -78,6 +78,8 @@
 #include <graphene/net/config.hpp>
 #include <graphene/net/exceptions.hpp>
 
+#include <graphene/utilities/tracer.hpp>
+
 #include <scorum/protocol/config.hpp>
 
 #include <fc/git_revision.hpp>
@@ -3299,6 +3301,8 @@ void node_impl::send_sync_block_to_node_delegate(const graphene::net::block_mess
         std::vector<fc::uint160_t> contained_transaction_message_ids;
         fc_ilog(fc::logger::get("sync"), "p2p pushing sync block #${block_num} ${block_hash}",
                 ("block_num", block_message_to_send.block.block_num())("block_hash", block_message_to_send.block_id));
+        graphene::utilities::trace_scope trace("send_sync_block_to_node_delegate", "p2p",
+                                               block_message_to_send.block.block_num());
         _delegate->handle_block(block_message_to_send, true, contained_transaction_message_ids);
         ilog("Successfully pushed sync block ${num} (id:${id})",
              ("num", block_message_to_send.block.block_num())("id", block_message_to_send.block_id));
@@ -3820,6 +3824,7 @@ void node_impl::process_block_message(peer_connection* originating_peer,
     // mode before we receive and process the item.  In that case, we should process the item as a normal
     // item to avoid confusing the sync code)
     graphene::net::block_message block_message_to_process(message_to_process.as<graphene::net::block_message>());
+    graphene::utilities::trace_scope trace("process_block_message", "p2p", block_message_to_process.block.block_num());
     auto item_iter
         = originating_peer->items_requested_from_peer.find(item_id(graphene::net::block_message_type, message_hash));
     if (item_iter != originating_peer->items_requested_from_peer.end())
@@ -232,8 +232,12 @@ void account_by_key_plugin::plugin_initialize(const boost::program_options::vari
         ilog("Initializing account_by_key plugin");
         chain::database& db = database();
 
-        db.pre_apply_operation.connect([&](const operation_notification& o) { my->pre_operation(o); });
-        db.post_apply_operation.connect([&](const operation_notification& o) { my->post_operation(o); });
+        using chain::operation_handlers;
+        // types processed by the visitors
+        db.pre_apply_operation_handlers.add(operation_handlers::make_visitor_mask<detail::pre_operation_visitor>(),
+                                            [&](const operation_notification& o) { my->pre_operation(o); });
+        db.post_apply_operation_handlers.add(operation_handlers::make_visitor_mask<detail::post_operation_visitor>(),
+                                             [&](const operation_notification& o) { my->post_operation(o); });
 
         db.add_plugin_index<key_lookup_index>();
     }
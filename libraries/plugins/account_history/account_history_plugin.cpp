@@ -5,6 +5,7 @@
 #include <scorum/protocol/config.hpp>
 
 #include <scorum/chain/database.hpp>
+#include <scorum/chain/history_store.hpp>
 #include <scorum/chain/operation_notification.hpp>
 #include <scorum/chain/schema/history_objects.hpp>
 
@@ -38,11 +39,20 @@ public:
 
     void on_operation(const operation_notification& note);
 
+    /**
+     * Called from the async_indexer thread when the history is kept in the history store.
+     */
+    void on_block(const indexed_block& block);
+
+    bool is_tracked(const account_name_type& account) const;
+
     account_history_plugin& _self;
     flat_map<account_name_type, account_name_type> _tracked_accounts;
     bool _filter_content = false;
     bool _blacklist = false;
     flat_set<std::string> _op_list;
+
+    std::shared_ptr<history_store> _store;
 };
 
 account_history_plugin_impl::~account_history_plugin_impl()
@@ -132,6 +142,57 @@ struct operation_visitor_filter : operation_visitor
     }
 };
 
+struct operation_filter
+{
+    operation_filter(const flat_set<std::string>& filter, bool blacklist)
+        : _filter(filter)
+        , _blacklist(blacklist)
+    {
+    }
+
+    typedef bool result_type;
+
+    const flat_set<std::string>& _filter;
+    bool _blacklist;
+
+    template <typename T> bool operator()(const T&) const
+    {
+        return (_filter.find(fc::get_typename<T>::name()) != _filter.end()) != _blacklist;
+    }
+};
+
+bool account_history_plugin_impl::is_tracked(const account_name_type& item) const
+{
+    auto itr = _tracked_accounts.lower_bound(item);
+
+    /*
+     * The map containing the ranges uses the key as the lower bound and the value as the upper bound.
+     * Because of this, if a value exists with the range (key, value], then calling lower_bound on
+     * the map will return the key of the next pair. Under normal circumstances of those ranges not
+     * intersecting, the value we are looking for will not be present in range that is returned via
+     * lower_bound.
+     *
+     * Consider the following example using ranges ["a","c"], ["g","i"]
+     * If we are looking for "bob", it should be tracked because it is in the lower bound.
+     * However, lower_bound( "bob" ) returns an iterator to ["g","i"]. So we need to decrement the iterator
+     * to get the correct range.
+     *
+     * If we are looking for "g", lower_bound( "g" ) will return ["g","i"], so we need to make sure we don't
+     * decrement.
+     *
+     * If the iterator points to the end, we should check the previous (equivalent to rbegin)
+     *
+     * And finally if the iterator is at the beginning, we should not decrement it for obvious reasons
+     */
+    if (itr != _tracked_accounts.begin()
+        && ((itr != _tracked_accounts.end() && itr->first != item) || itr == _tracked_accounts.end()))
+    {
+        --itr;
+    }
+
+    return !_tracked_accounts.size() || (itr != _tracked_accounts.end() && itr->first <= item && item <= itr->second);
+}
+
 void account_history_plugin_impl::on_operation(const operation_notification& note)
 {
     flat_set<account_name_type> impacted;
@@ -142,34 +203,7 @@ void account_history_plugin_impl::on_operation(const operation_notification& not
 
     for (const auto& item : impacted)
     {
-        auto itr = _tracked_accounts.lower_bound(item);
-
-        /*
-         * The map containing the ranges uses the key as the lower bound and the value as the upper bound.
-         * Because of this, if a value exists with the range (key, value], then calling lower_bound on
-         * the map will return the key of the next pair. Under normal circumstances of those ranges not
-         * intersecting, the value we are looking for will not be present in range that is returned via
-         * lower_bound.
-         *
-         * Consider the following example using ranges ["a","c"], ["g","i"]
-         * If we are looking for "bob", it should be tracked because it is in the lower bound.
-         * However, lower_bound( "bob" ) returns an iterator to ["g","i"]. So we need to decrement the iterator
-         * to get the correct range.
-         *
-         * If we are looking for "g", lower_bound( "g" ) will return ["g","i"], so we need to make sure we don't
-         * decrement.
-         *
-         * If the iterator points to the end, we should check the previous (equivalent to rbegin)
-         *
-         * And finally if the iterator is at the beginning, we should not decrement it for obvious reasons
-         */
-        if (itr != _tracked_accounts.begin()
-            && ((itr != _tracked_accounts.end() && itr->first != item) || itr == _tracked_accounts.end()))
-        {
-            --itr;
-        }
-
-        if (!_tracked_accounts.size() || (itr != _tracked_accounts.end() && itr->first <= item && item <= itr->second))
+        if (is_tracked(item))
         {
             if (_filter_content)
             {
@@ -183,6 +217,35 @@ void account_history_plugin_impl::on_operation(const operation_notification& not
     }
 }
 
+void account_history_plugin_impl::on_block(const indexed_block& block)
+{
+    // blocks indexed before a restart are fed again when the chain is replayed
+    if (block.block_num <= _store->head_block_num())
+        return;
+
+    for (const indexed_operation& op : block.operations)
+    {
+        if (_filter_content && !op.op.visit(operation_filter(_op_list, _blacklist)))
+            continue;
+
+        flat_set<account_name_type> impacted;
+        app::operation_get_impacted_accounts(op.op, impacted);
+
+        std::vector<account_name_type> accounts;
+        for (const auto& item : impacted)
+        {
+            if (is_tracked(item))
+                accounts.push_back(item);
+        }
+
+        if (!accounts.empty())
+            _store->append(op, accounts);
+    }
+
+    _store->set_head_block_num(block.block_num);
+    _store->commit(block.last_irreversible_block_num);
+}
+
 } // end namespace detail
 
 account_history_plugin::account_history_plugin(application* app)
@@ -210,14 +273,35 @@ void account_history_plugin::plugin_set_program_options(boost::program_options::
         "times")("history-whitelist-ops", boost::program_options::value<std::vector<std::string>>()->composing(),
                  "Defines a list of operations which will be explicitly logged.")(
         "history-blacklist-ops", boost::program_options::value<std::vector<std::string>>()->composing(),
-        "Defines a list of operations which will be explicitly ignored.");
+        "Defines a list of operations which will be explicitly ignored.")(
+        "history-async-indexing", "Index the history on a separate thread into files outside of shared memory")(
+        "history-dir", boost::program_options::value<boost::filesystem::path>()->default_value("account_history"),
+        "Directory of the history indexed asynchronously, relative to data-dir");
     cfg.add(cli);
 }
 
 void account_history_plugin::plugin_initialize(const boost::program_options::variables_map& options)
 {
     // ilog("Intializing account history plugin" );
-    database().pre_apply_operation.connect([&](const operation_notification& note) { my->on_operation(note); });
+    if (options.count("history-async-indexing"))
+    {
+        fc::path dir = fc::path(options.at("history-dir").as<boost::filesystem::path>());
+        if (dir.is_relative())
+            dir = fc::path(options.at("data-dir").as<boost::filesystem::path>()) / dir;
+
+        my->_store = std::make_shared<history_store>();
+        my->_store->open(dir);
+        database().set_history_store(my->_store);
+        database().get_async_indexer().add_consumer(
+            plugin_name(), [&](const indexed_block& block) { my->on_block(block); },
+            [&](uint32_t block_num) { my->_store->pop_blocks(block_num); });
+
+        ilog("Account History: indexing asynchronously");
+    }
+    else
+    {
+        database().pre_apply_operation.connect([&](const operation_notification& note) { my->on_operation(note); });
+    }
 
     typedef std::pair<account_name_type, account_name_type> pairstring;
     LOAD_VALUE_SET(options, "track-account-range", my->_tracked_accounts, pairstring);
@@ -265,6 +349,27 @@ void account_history_plugin::plugin_startup()
 {
     ilog("account_history plugin: plugin_startup() begin");
 
+    if (my->_store)
+    {
+        const uint32_t head_block_num = database().head_block_num();
+
+        // blocks of the window could be lost with the shared memory state
+        if (my->_store->head_block_num() > head_block_num)
+            my->_store->pop_blocks(head_block_num);
+
+        if (my->_store->committed_block_num() > head_block_num)
+        {
+            wlog("Account history is indexed up to block ${b} which is above the head block ${h}, remove the history "
+                 "directory to rebuild it",
+                 ("b", my->_store->committed_block_num())("h", head_block_num));
+        }
+        else if (my->_store->head_block_num() < head_block_num)
+        {
+            wlog("Account history is indexed up to block ${b}, replay the blockchain to index blocks up to ${h}",
+                 ("b", my->_store->head_block_num())("h", head_block_num));
+        }
+    }
+
     ilog("account_history plugin: plugin_startup() end");
 }
 
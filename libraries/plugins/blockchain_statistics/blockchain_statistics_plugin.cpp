@@ -27,7 +27,8 @@ public:
     }
 
     void on_block(const signed_block& b);
-    void pre_operation(const operation_notification& o);
+    void pre_operation(const delete_comment_operation& op);
+    void pre_operation(const withdraw_vesting_operation& op);
     void post_operation(const operation_notification& o);
 
     blockchain_statistics_plugin& _self;
@@ -241,46 +242,47 @@ void blockchain_statistics_plugin_impl::on_block(const signed_block& b)
     }
 }
 
-void blockchain_statistics_plugin_impl::pre_operation(const operation_notification& o)
+void blockchain_statistics_plugin_impl::pre_operation(const delete_comment_operation& op)
 {
     auto& db = _self.database();
 
     for (auto bucket_id : _current_buckets)
     {
-        if (o.op.which() == operation::tag<delete_comment_operation>::value)
-        {
-            delete_comment_operation op = o.op.get<delete_comment_operation>();
-            auto comment = db.get_comment(op.author, op.permlink);
-            const auto& bucket = db.get(bucket_id);
+        auto comment = db.get_comment(op.author, op.permlink);
+        const auto& bucket = db.get(bucket_id);
 
-            db.modify(bucket, [&](bucket_object& b) {
-                if (comment.parent_author.length())
-                    b.replies_deleted++;
-                else
-                    b.root_comments_deleted++;
-            });
-        }
-        else if (o.op.which() == operation::tag<withdraw_vesting_operation>::value)
-        {
-            withdraw_vesting_operation op = o.op.get<withdraw_vesting_operation>();
-            const auto& account = db.get_account(op.account);
-            const auto& bucket = db.get(bucket_id);
+        db.modify(bucket, [&](bucket_object& b) {
+            if (comment.parent_author.length())
+                b.replies_deleted++;
+            else
+                b.root_comments_deleted++;
+        });
+    }
+}
 
-            auto new_vesting_withdrawal_rate = op.vesting_shares.amount / SCORUM_VESTING_WITHDRAW_INTERVALS;
-            if (op.vesting_shares.amount > 0 && new_vesting_withdrawal_rate == 0)
-                new_vesting_withdrawal_rate = 1;
+void blockchain_statistics_plugin_impl::pre_operation(const withdraw_vesting_operation& op)
+{
+    auto& db = _self.database();
 
-            db.modify(bucket, [&](bucket_object& b) {
-                if (account.vesting_withdraw_rate.amount > 0)
-                    b.modified_vesting_withdrawal_requests++;
-                else
-                    b.new_vesting_withdrawal_requests++;
+    for (auto bucket_id : _current_buckets)
+    {
+        const auto& account = db.get_account(op.account);
+        const auto& bucket = db.get(bucket_id);
 
-                // TODO: Figure out how to change delta when a vesting withdraw finishes. Have until March 24th 2018 to
-                // figure that out...
-                b.vesting_withdraw_rate_delta += new_vesting_withdrawal_rate - account.vesting_withdraw_rate.amount;
-            });
-        }
+        auto new_vesting_withdrawal_rate = op.vesting_shares.amount / SCORUM_VESTING_WITHDRAW_INTERVALS;
+        if (op.vesting_shares.amount > 0 && new_vesting_withdrawal_rate == 0)
+            new_vesting_withdrawal_rate = 1;
+
+        db.modify(bucket, [&](bucket_object& b) {
+            if (account.vesting_withdraw_rate.amount > 0)
+                b.modified_vesting_withdrawal_requests++;
+            else
+                b.new_vesting_withdrawal_requests++;
+
+            // TODO: Figure out how to change delta when a vesting withdraw finishes. Have until March 24th 2018 to
+            // figure that out...
+            b.vesting_withdraw_rate_delta += new_vesting_withdrawal_rate - account.vesting_withdraw_rate.amount;
+        });
     }
 }
 
@@ -337,7 +339,14 @@ void blockchain_statistics_plugin::plugin_initialize(const boost::program_option
         chain::database& db = database();
 
         db.applied_block.connect([&](const signed_block& b) { _my->on_block(b); });
-        db.pre_apply_operation.connect([&](const operation_notification& o) { _my->pre_operation(o); });
+        db.pre_apply_operation_handlers.add<protocol::delete_comment_operation>(
+            [&](const protocol::delete_comment_operation& op, const operation_notification&) {
+                _my->pre_operation(op);
+            });
+        db.pre_apply_operation_handlers.add<protocol::withdraw_vesting_operation>(
+            [&](const protocol::withdraw_vesting_operation& op, const operation_notification&) {
+                _my->pre_operation(op);
+            });
         db.post_apply_operation.connect([&](const operation_notification& o) { _my->post_operation(o); });
 
         db.add_plugin_index<bucket_index>();
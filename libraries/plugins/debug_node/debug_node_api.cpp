@@ -14,6 +14,7 @@
 #include <scorum/chain/schema/witness_objects.hpp>
 
 #include <graphene/utilities/key_conversion.hpp>
+#include <graphene/utilities/tracer.hpp>
 
 #include <scorum/plugins/debug_node/debug_node_api.hpp>
 #include <scorum/plugins/debug_node/debug_node_plugin.hpp>
@@ -64,6 +65,10 @@ public:
     void debug_stream_json_objects_flush();
     void debug_set_hardfork(uint32_t hardfork_id);
     bool debug_has_hardfork(uint32_t hardfork_id);
+    void debug_enable_operation_profiler(bool enable);
+    std::vector<scorum::chain::operation_profile> debug_get_operation_profile();
+    void debug_reset_operation_profile();
+    std::string debug_dump_trace(const std::string& name);
     void debug_get_json_schema(std::string& schema);
     void debug_set_dev_key_prefix(std::string prefix);
     void debug_get_dev_key(get_dev_key_result& result, const get_dev_key_args& args);
@@ -262,6 +267,35 @@ bool debug_node_api_impl::debug_has_hardfork(uint32_t hardfork_id)
     return app.chain_database()->get(scorum::chain::hardfork_property_id_type()).last_hardfork >= hardfork_id;
 }
 
+void debug_node_api_impl::debug_enable_operation_profiler(bool enable)
+{
+    std::shared_ptr<scorum::chain::database> db = app.chain_database();
+    db->with_write_lock([&]() {
+        if (enable)
+            db->get_operation_profiler().enable();
+        else
+            db->get_operation_profiler().disable();
+    });
+}
+
+std::vector<scorum::chain::operation_profile> debug_node_api_impl::debug_get_operation_profile()
+{
+    std::shared_ptr<scorum::chain::database> db = app.chain_database();
+    return db->with_read_lock([&]() { return db->get_operation_profiler().get_profiles(); });
+}
+
+void debug_node_api_impl::debug_reset_operation_profile()
+{
+    std::shared_ptr<scorum::chain::database> db = app.chain_database();
+    db->with_write_lock([&]() { db->get_operation_profiler().reset(); });
+}
+
+std::string debug_node_api_impl::debug_dump_trace(const std::string& name)
+{
+    FC_ASSERT(!name.empty() && name.find_first_of("/\\") == std::string::npos, "Invalid trace name");
+    return graphene::utilities::tracer::instance().dump(name).string();
+}
+
 } // detail
 
 debug_node_api::debug_node_api(const scorum::app::api_context& ctx)
@@ -364,6 +398,26 @@ bool debug_node_api::debug_has_hardfork(uint32_t hardfork_id)
 {
     return my->debug_has_hardfork(hardfork_id);
 }
+
+void debug_node_api::debug_enable_operation_profiler(bool enable)
+{
+    my->debug_enable_operation_profiler(enable);
+}
+
+std::vector<scorum::chain::operation_profile> debug_node_api::debug_get_operation_profile()
+{
+    return my->debug_get_operation_profile();
+}
+
+void debug_node_api::debug_reset_operation_profile()
+{
+    my->debug_reset_operation_profile();
+}
+
+std::string debug_node_api::debug_dump_trace(std::string name)
+{
+    return my->debug_dump_trace(name);
+}
 }
 }
 } // scorum::plugin::debug_node
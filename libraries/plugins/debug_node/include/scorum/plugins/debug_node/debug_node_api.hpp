@@ -11,6 +11,7 @@
 #include <scorum/protocol/block.hpp>
 
 #include <scorum/chain/schema/witness_objects.hpp>
+#include <scorum/chain/operation_profiler.hpp>
 
 namespace scorum {
 namespace app {
@@ -124,6 +125,21 @@ public:
 
     bool debug_has_hardfork(uint32_t hardfork_id);
 
+    /**
+     * Start or stop collecting execution time of operations by type.
+     */
+    void debug_enable_operation_profiler(bool enable);
+
+    std::vector<scorum::chain::operation_profile> debug_get_operation_profile();
+
+    void debug_reset_operation_profile();
+
+    /**
+     * Write recorded block processing spans in Chrome trace format to <trace-dir>/<name>.json.
+     * @return path of the written file
+     */
+    std::string debug_dump_trace(std::string name);
+
     std::shared_ptr<detail::debug_node_api_impl> my;
 };
 } // namespace debug_node
@@ -145,6 +161,10 @@ FC_API(scorum::plugin::debug_node::debug_node_api,
        (debug_get_witness_schedule)
        (debug_get_hardfork_property_object)
        (debug_set_dev_key_prefix)
-       (debug_get_dev_key))
+       (debug_get_dev_key)
+       (debug_enable_operation_profiler)
+       (debug_get_operation_profile)
+       (debug_reset_operation_profile)
+       (debug_dump_trace))
 
 // clang-format on
@@ -383,8 +383,12 @@ void follow_plugin::plugin_initialize(const boost::program_options::variables_ma
         chain::database& db = database();
         my->plugin_initialize();
 
-        db.pre_apply_operation.connect([&](const operation_notification& o) { my->pre_operation(o); });
-        db.post_apply_operation.connect([&](const operation_notification& o) { my->post_operation(o); });
+        using chain::operation_handlers;
+        // types processed by the visitors
+        db.pre_apply_operation_handlers.add(operation_handlers::make_visitor_mask<detail::pre_operation_visitor>(),
+                                            [&](const operation_notification& o) { my->pre_operation(o); });
+        db.post_apply_operation_handlers.add(operation_handlers::make_visitor_mask<detail::post_operation_visitor>(),
+                                             [&](const operation_notification& o) { my->post_operation(o); });
 
         db.add_plugin_index<follow_index>();
         db.add_plugin_index<feed_index>();
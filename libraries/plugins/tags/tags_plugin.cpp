@@ -39,7 +39,13 @@ public:
         return _self.database();
     }
 
-    void on_operation(const operation_notification& note);
+    template <typename Operation> void on_operation(const Operation& op);
+
+    template <typename Operation> void subscribe()
+    {
+        database().post_apply_operation_handlers.add<Operation>(
+            [this](const Operation& op, const operation_notification&) { on_operation(op); });
+    }
 
     tags_plugin& _self;
 };
@@ -471,18 +477,14 @@ struct operation_visitor
         const auto& c = _db.get_comment(op.author, op.permlink);
         update_tags(c);
     }
-
-    template <typename Op> void operator()(Op&&) const
-    {
-    } /// ignore all other ops
 };
 
-void tags_plugin_impl::on_operation(const operation_notification& note)
+template <typename Operation> void tags_plugin_impl::on_operation(const Operation& op)
 {
     try
     {
         /// plugins shouldn't ever throw
-        note.op.visit(operation_visitor(database()));
+        operation_visitor(database())(op);
     }
     catch (const fc::exception& e)
     {
@@ -520,7 +522,13 @@ void tags_plugin::plugin_set_program_options(boost::program_options::options_des
 void tags_plugin::plugin_initialize(const boost::program_options::variables_map& options)
 {
     ilog("Intializing tags plugin");
-    database().post_apply_operation.connect([&](const operation_notification& note) { my->on_operation(note); });
+
+    my->subscribe<protocol::comment_operation>();
+    my->subscribe<protocol::transfer_operation>();
+    my->subscribe<protocol::vote_operation>();
+    my->subscribe<protocol::delete_comment_operation>();
+    my->subscribe<protocol::comment_reward_operation>();
+    my->subscribe<protocol::comment_payout_update_operation>();
 
     app().register_api_factory<tag_api>("tag_api");
 }
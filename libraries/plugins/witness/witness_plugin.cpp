@@ -476,7 +476,9 @@ void witness_plugin::plugin_initialize(const boost::program_options::variables_m
         chain::database& db = database();
 
         db.on_pre_apply_transaction.connect([&](const signed_transaction& tx) { _my->pre_transaction(tx); });
-        db.pre_apply_operation.connect([&](const operation_notification& note) { _my->pre_operation(note); });
+        // types processed by the visitor
+        db.pre_apply_operation_handlers.add(chain::operation_handlers::make_visitor_mask<detail::operation_visitor>(),
+                                            [&](const operation_notification& note) { _my->pre_operation(note); });
         db.applied_block.connect([&](const signed_block& b) { _my->on_block(b); });
 
         db.add_plugin_index<account_bandwidth_index>();
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <fc/filesystem.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace graphene {
+namespace utilities {
+
+struct trace_event
+{
+    const char* name = nullptr;
+    const char* category = nullptr;
+    uint64_t start_us = 0;
+    uint64_t duration_us = 0;
+    uint64_t thread_id = 0;
+
+    /// event specific value (block number, transaction index), shown as args.value in the trace
+    uint64_t value = 0;
+};
+
+/**
+ *  Ring buffer of timed spans exported in Chrome trace event format (chrome://tracing, ui.perfetto.dev),
+ *  instance() is the process wide tracer spans of trace_scope are recorded to.
+ *
+ *  Recording is lock-free: a writer takes a slot by incrementing a counter and publishes the span with a sequence
+ *  number, the oldest spans are overwritten. Readers skip slots which are being written. Names and categories must
+ *  be string literals. Nothing is recorded until the buffer is allocated with start.
+ */
+class tracer
+{
+public:
+    static tracer& instance();
+
+    ~tracer();
+
+    /**
+     * Allocate the buffer for given number of spans and start recording, the tracer must be stopped.
+     */
+    void start(uint32_t capacity, const fc::path& dump_dir);
+
+    /**
+     * Stop recording and drop recorded spans after requested dumps are written. Spans must not be recorded while
+     * the tracer is stopped.
+     */
+    void stop();
+
+    bool enabled() const
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    void record(const char* name, const char* category, uint64_t start_us, uint64_t duration_us, uint64_t value = 0);
+
+    /**
+     * Recorded spans in order of recording.
+     */
+    std::vector<trace_event> get_events() const;
+
+    void write_chrome_trace(const fc::path& file) const;
+
+    /**
+     * Write spans to <dump_dir>/<name>.json.
+     * @return path of the written file
+     */
+    fc::path dump(const std::string& name) const;
+
+    /**
+     * Dump spans from a background thread once trace scopes open on the calling thread are closed, so the dump
+     * has spans of the whole call and it is not written while locks taken within the scopes are held.
+     */
+    void dump_after_scopes(const std::string& name);
+
+    /**
+     * Wait until requested background dumps are written.
+     */
+    void wait_for_dumps();
+
+    static uint64_t now_us();
+
+    /// called by trace_scope to count open scopes of the thread
+    void enter_scope();
+    void leave_scope();
+
+private:
+    struct slot
+    {
+        // 2 * index + 1 while written, 2 * index + 2 when published
+        std::atomic<uint64_t> sequence{ 0 };
+
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<const char*> category{ nullptr };
+        std::atomic<uint64_t> start_us{ 0 };
+        std::atomic<uint64_t> duration_us{ 0 };
+        std::atomic<uint64_t> thread_id{ 0 };
+        std::atomic<uint64_t> value{ 0 };
+    };
+
+    std::atomic<bool> _enabled{ false };
+    std::atomic<uint64_t> _next{ 0 };
+
+    std::unique_ptr<slot[]> _slots;
+    uint32_t _capacity = 0;
+
+    fc::path _dump_dir;
+
+    void dump_async(const std::string& name);
+    void run_dumps();
+
+    std::mutex _dump_mutex;
+    std::deque<std::string> _dump_queue;
+    std::thread _dump_thread;
+    bool _dumping = false;
+};
+
+/**
+ *  Records the time from construction to destruction as a span when the tracer is enabled.
+ */
+class trace_scope
+{
+public:
+    trace_scope(const char* name, const char* category, uint64_t value = 0)
+        : _name(name)
+        , _category(category)
+        , _value(value)
+        , _start_us(tracer::instance().enabled() ? tracer::now_us() : 0)
+    {
+        if (_start_us != 0)
+            tracer::instance().enter_scope();
+    }
+
+    ~trace_scope()
+    {
+        if (_start_us != 0)
+        {
+            const uint64_t end_us = tracer::now_us();
+            tracer::instance().record(_name, _category, _start_us, end_us - _start_us, _value);
+            tracer::instance().leave_scope();
+        }
+    }
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+private:
+    const char* _name;
+    const char* _category;
+    uint64_t _value;
+    uint64_t _start_us;
+};
+}
+} // graphene::utilities
@@ -0,0 +1,234 @@
+#include <graphene/utilities/tracer.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace graphene {
+namespace utilities {
+
+namespace {
+
+// trace scopes open on the thread and dumps waiting for them to close
+thread_local uint32_t open_scopes = 0;
+thread_local std::vector<std::string> deferred_dumps;
+}
+
+tracer& tracer::instance()
+{
+    static tracer t;
+    return t;
+}
+
+tracer::~tracer()
+{
+    wait_for_dumps();
+}
+
+void tracer::start(uint32_t capacity, const fc::path& dump_dir)
+{
+    FC_ASSERT(!_slots, "Tracer is already started");
+    FC_ASSERT(capacity > 0);
+
+    _slots.reset(new slot[capacity]);
+    _capacity = capacity;
+    _dump_dir = dump_dir;
+
+    _enabled.store(true, std::memory_order_release);
+}
+
+void tracer::stop()
+{
+    wait_for_dumps();
+
+    _enabled.store(false, std::memory_order_release);
+    _slots.reset();
+    _capacity = 0;
+    _next.store(0, std::memory_order_relaxed);
+    _dump_dir = fc::path();
+}
+
+void tracer::record(const char* name, const char* category, uint64_t start_us, uint64_t duration_us, uint64_t value)
+{
+    if (!_enabled.load(std::memory_order_acquire))
+        return;
+
+    const uint64_t index = _next.fetch_add(1, std::memory_order_relaxed);
+    slot& s = _slots[index % _capacity];
+
+    s.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s.name.store(name, std::memory_order_relaxed);
+    s.category.store(category, std::memory_order_relaxed);
+    s.start_us.store(start_us, std::memory_order_relaxed);
+    s.duration_us.store(duration_us, std::memory_order_relaxed);
+    s.thread_id.store(std::hash<std::thread::id>()(std::this_thread::get_id()), std::memory_order_relaxed);
+    s.value.store(value, std::memory_order_relaxed);
+
+    s.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<trace_event> tracer::get_events() const
+{
+    std::vector<trace_event> events;
+
+    if (!_enabled.load(std::memory_order_acquire))
+        return events;
+
+    const uint64_t end = _next.load(std::memory_order_relaxed);
+    const uint64_t begin = end > _capacity ? end - _capacity : 0;
+
+    events.reserve(end - begin);
+
+    for (uint64_t index = begin; index < end; ++index)
+    {
+        const slot& s = _slots[index % _capacity];
+
+        const uint64_t sequence = s.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * index + 2)
+            continue;
+
+        trace_event e;
+        e.name = s.name.load(std::memory_order_relaxed);
+        e.category = s.category.load(std::memory_order_relaxed);
+        e.start_us = s.start_us.load(std::memory_order_relaxed);
+        e.duration_us = s.duration_us.load(std::memory_order_relaxed);
+        e.thread_id = s.thread_id.load(std::memory_order_relaxed);
+        e.value = s.value.load(std::memory_order_relaxed);
+
+        // the slot could be taken by a newer span while it was read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+
+        events.push_back(e);
+    }
+
+    return events;
+}
+
+void tracer::write_chrome_trace(const fc::path& file) const
+{
+    std::ofstream out(file.string());
+    FC_ASSERT(out.good(), "Could not open trace file ${f}", ("f", file));
+
+    out << "{\"traceEvents\":[";
+
+    bool first = true;
+    for (const trace_event& e : get_events())
+    {
+        if (!first)
+            out << ",";
+        first = false;
+
+        out << "\n{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\",\"ts\":" << e.start_us
+            << ",\"dur\":" << e.duration_us << ",\"pid\":1,\"tid\":" << (uint32_t)e.thread_id
+            << ",\"args\":{\"value\":" << e.value << "}}";
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+fc::path tracer::dump(const std::string& name) const
+{
+    FC_ASSERT(enabled(), "Tracing is not enabled");
+
+    if (!fc::exists(_dump_dir))
+        fc::create_directories(_dump_dir);
+
+    fc::path file = _dump_dir / (name + ".json");
+    write_chrome_trace(file);
+    return file;
+}
+
+void tracer::dump_after_scopes(const std::string& name)
+{
+    if (open_scopes == 0)
+        dump_async(name);
+    else
+        deferred_dumps.push_back(name);
+}
+
+void tracer::wait_for_dumps()
+{
+    std::thread t;
+    {
+        std::lock_guard<std::mutex> lock(_dump_mutex);
+        t = std::move(_dump_thread);
+    }
+
+    // dumps requested meanwhile are written by the same thread
+    if (t.joinable())
+        t.join();
+}
+
+void tracer::enter_scope()
+{
+    ++open_scopes;
+}
+
+void tracer::leave_scope()
+{
+    if (open_scopes > 0 && --open_scopes == 0 && !deferred_dumps.empty())
+    {
+        for (const std::string& name : deferred_dumps)
+        {
+            dump_async(name);
+        }
+        deferred_dumps.clear();
+    }
+}
+
+void tracer::dump_async(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(_dump_mutex);
+
+    _dump_queue.push_back(name);
+    if (_dumping)
+        return;
+
+    // the previous thread has written its dumps
+    if (_dump_thread.joinable())
+        _dump_thread.join();
+
+    _dumping = true;
+    _dump_thread = std::thread(&tracer::run_dumps, this);
+}
+
+void tracer::run_dumps()
+{
+    std::unique_lock<std::mutex> lock(_dump_mutex);
+
+    while (!_dump_queue.empty())
+    {
+        std::string name = std::move(_dump_queue.front());
+        _dump_queue.pop_front();
+
+        lock.unlock();
+        try
+        {
+            fc::path file = dump(name);
+            wlog("Trace ${n} is written to ${f}", ("n", name)("f", file));
+        }
+        catch (const fc::exception& e)
+        {
+            elog("Failed to write trace ${n}: ${e}", ("n", name)("e", e.to_detail_string()));
+        }
+        lock.lock();
+    }
+
+    _dumping = false;
+}
+
+uint64_t tracer::now_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+}
+} // graphene::utilities
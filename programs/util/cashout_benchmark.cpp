@@ -0,0 +1,99 @@
+
+#include <scorum/chain/util/reward.hpp>
+
+#include <fc/time.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+/**
+ *  Compares reward evaluation of a payout heavy block done comment by comment (as it was done by
+ *  process_comment_cashout) with the batched evaluation. Usage: cashout_benchmark [comments] [rounds]
+ */
+int main(int argc, char** argv, char** envp)
+{
+    const size_t comments = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> rshares_distribution(-1000000000, 1000000000000000);
+
+    std::vector<share_type> rshares;
+    std::vector<uint16_t> weights;
+    std::vector<asset> max_scr;
+    for (size_t i = 0; i < comments; ++i)
+    {
+        rshares.push_back(rshares_distribution(rng));
+        weights.push_back(SCORUM_100_PERCENT);
+        max_scr.push_back(asset(1000000000000, SCORUM_SYMBOL));
+    }
+
+    const asset reward_fund(100000000000, SCORUM_SYMBOL);
+    const fc::uint128_t recent_claims = 1000000000;
+
+    std::vector<share_type> single_payouts(comments);
+    std::vector<share_type> batch_payouts(comments);
+
+    fc::microseconds single_time;
+    fc::microseconds batch_time;
+
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        auto start = fc::time_point::now();
+
+        fc::uint128_t total_claims = recent_claims;
+        for (size_t i = 0; i < comments; ++i)
+        {
+            if (rshares[i] > 0)
+                total_claims += util::evaluate_reward_curve(rshares[i].value, quadratic);
+        }
+
+        for (size_t i = 0; i < comments; ++i)
+        {
+            if (rshares[i] > 0)
+            {
+                util::comment_reward_context ctx;
+                ctx.total_reward_shares2 = total_claims;
+                ctx.total_reward_fund_scorum = reward_fund;
+                ctx.reward_curve = quadratic;
+                ctx.rshares = rshares[i];
+                ctx.reward_weight = weights[i];
+                ctx.max_scr = max_scr[i];
+
+                single_payouts[i] = util::get_rshare_reward(ctx);
+            }
+        }
+
+        single_time += fc::time_point::now() - start;
+        start = fc::time_point::now();
+
+        util::comment_reward_batch batch;
+        batch.reserve(comments);
+        for (size_t i = 0; i < comments; ++i)
+        {
+            batch.push_back(rshares[i], weights[i], max_scr[i]);
+        }
+
+        batch.evaluate_payouts(recent_claims + batch.evaluate_claims(quadratic), reward_fund);
+        batch_payouts.swap(batch.payouts);
+
+        batch_time += fc::time_point::now() - start;
+    }
+
+    if (single_payouts != batch_payouts)
+    {
+        std::cerr << "payouts differ" << std::endl;
+        return 1;
+    }
+
+    std::cout << comments << " comments, " << rounds << " rounds" << std::endl;
+    std::cout << "single: " << single_time.count() / rounds << " us per block" << std::endl;
+    std::cout << "batch:  " << batch_time.count() / rounds << " us per block" << std::endl;
+
+    return 0;
+}
@@ -36,18 +36,18 @@ int main(int argc, char** argv, char** envp)
         idump((log.head()));
         idump((fc::raw::pack_size(b2)));
 
-        auto r1 = log.read_block(0);
+        auto r1 = log.read_block_by_num(1);
         idump((r1));
-        idump((fc::raw::pack_size(r1.first)));
+        idump((fc::raw::pack_size(*r1)));
 
-        auto r2 = log.read_block(r1.second);
+        auto r2 = log.read_block_by_num(2);
         idump((r2));
-        idump((fc::raw::pack_size(r2.first)));
+        idump((fc::raw::pack_size(*r2)));
 
         idump((log.read_head()));
         idump((fc::raw::pack_size(log.read_head())));
 
-        auto r3 = log.read_block(r2.second);
+        auto r3 = log.read_block_by_num(3);
         idump((r3));
     }
     catch (const std::exception& e)
@@ -0,0 +1,42 @@
+#include <scorum/chain/block_log.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <iostream>
+
+int main(int argc, char** argv, char** envp)
+{
+    try
+    {
+        if (argc < 2)
+        {
+            std::cerr << "Usage: " << argv[0] << " <path to block_log> [threads]\n";
+            return 1;
+        }
+
+        uint32_t threads = argc > 2 ? (uint32_t)std::stoul(argv[2]) : 0;
+
+        scorum::chain::block_log log;
+        log.open(fc::path(argv[1]));
+
+        auto start = fc::time_point::now();
+        auto result = log.verify(threads);
+        auto end = fc::time_point::now();
+
+        std::cout << fc::json::to_pretty_string(result) << "\n";
+        ilog("Verified ${n} blocks in ${t} sec",
+             ("n", result.verified_blocks)("t", double((end - start).count()) / 1000000.0));
+
+        return result.errors.empty() ? 0 : 2;
+    }
+    catch (const fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+    }
+    catch (const std::exception& e)
+    {
+        edump((std::string(e.what())));
+    }
+
+    return 1;
+}
@@ -470,7 +470,7 @@ void database_fixture::validate_database(void)
 {
     try
     {
-        db.validate_invariants();
+        db.audit_invariants();
     }
     FC_LOG_AND_RETHROW();
 }
@@ -111,6 +111,18 @@ BOOST_AUTO_TEST_CASE(check_fee_after_creation)
     FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE(service_is_created_once)
+{
+    try
+    {
+        BOOST_CHECK_EQUAL(&db.obtain_service<dbs_account>(), &data_service);
+
+        account_service_i& service = db.account_service();
+        BOOST_CHECK_EQUAL(&service, static_cast<account_service_i*>(&data_service));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace chain
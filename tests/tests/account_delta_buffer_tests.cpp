@@ -0,0 +1,76 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/account_delta_buffer.hpp>
+
+#include <scorum/chain/schema/account_objects.hpp>
+#include <scorum/chain/schema/dynamic_global_property_object.hpp>
+
+#include "database_fixture.hpp"
+
+using namespace scorum;
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+BOOST_FIXTURE_TEST_SUITE(account_delta_buffer_tests, clean_database_fixture)
+
+SCORUM_TEST_CASE(changes_are_applied_on_flush)
+{
+    ACTORS((alice)(bob))
+
+    const auto& props = db.get_dynamic_global_properties();
+
+    const asset alice_vesting = alice.vesting_shares;
+    const asset bob_balance = bob.balance;
+    const asset total_vesting = props.total_vesting_shares;
+    const asset total_balance = props.total_accounts_balance;
+
+    account_delta_buffer deltas(db);
+
+    asset created = deltas.create_vesting(alice, ASSET("1.000 SCR"));
+    created += deltas.create_vesting(alice, ASSET("2.000 SCR"));
+    deltas.increase_balance(bob, ASSET("0.500 SCR"));
+
+    BOOST_REQUIRE_EQUAL(created, ASSET("3.000 SCR") * props.get_vesting_share_price());
+
+    // nothing is written before flush
+    BOOST_REQUIRE_EQUAL(alice.vesting_shares, alice_vesting);
+    BOOST_REQUIRE_EQUAL(bob.balance, bob_balance);
+    BOOST_REQUIRE_EQUAL(props.total_vesting_shares, total_vesting);
+
+    deltas.flush();
+
+    BOOST_REQUIRE(deltas.empty());
+    BOOST_REQUIRE_EQUAL(alice.vesting_shares, alice_vesting + created);
+    BOOST_REQUIRE_EQUAL(bob.balance, bob_balance + ASSET("0.500 SCR"));
+    BOOST_REQUIRE_EQUAL(props.total_vesting_shares, total_vesting + created);
+    BOOST_REQUIRE_EQUAL(props.total_accounts_balance, total_balance + ASSET("0.500 SCR"));
+}
+
+SCORUM_TEST_CASE(flush_single_account)
+{
+    ACTORS((alice)(bob))
+
+    const asset alice_balance = alice.balance;
+    const asset bob_balance = bob.balance;
+
+    account_delta_buffer deltas(db);
+
+    deltas.increase_balance(alice, ASSET("0.100 SCR"));
+    deltas.increase_balance(bob, ASSET("0.200 SCR"));
+
+    deltas.flush(alice);
+
+    BOOST_REQUIRE_EQUAL(alice.balance, alice_balance + ASSET("0.100 SCR"));
+    BOOST_REQUIRE_EQUAL(bob.balance, bob_balance);
+    BOOST_REQUIRE(!deltas.empty());
+
+    deltas.flush();
+
+    BOOST_REQUIRE_EQUAL(alice.balance, alice_balance + ASSET("0.100 SCR"));
+    BOOST_REQUIRE_EQUAL(bob.balance, bob_balance + ASSET("0.200 SCR"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,392 @@
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/async_indexer.hpp>
+#include <scorum/chain/history_store.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include "defines.hpp"
+
+#include <fstream>
+
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+namespace {
+
+void apply_block(async_indexer& indexer, uint32_t block_num, const std::vector<operation>& ops)
+{
+    indexer.begin_block(block_num, block_id_type(), fc::time_point_sec());
+    for (const operation& op : ops)
+    {
+        operation_notification note(op);
+        note.block = block_num;
+        indexer.add_operation(note, fc::time_point_sec());
+    }
+    indexer.end_block(0);
+}
+
+indexed_operation make_operation(uint32_t block_num, const std::string& voter)
+{
+    vote_operation vote;
+    vote.voter = voter;
+
+    indexed_operation op;
+    op.block = block_num;
+    op.op = vote;
+    return op;
+}
+
+void append_block(history_store& store, uint32_t block_num)
+{
+    indexed_operation op = make_operation(block_num, "alice");
+    op.trx_id = transaction_id_type::hash(std::to_string(block_num));
+    store.append(op, { "alice" });
+    store.set_head_block_num(block_num);
+    store.commit(block_num - 1);
+}
+
+// emulate records written after the last saved state, as a crash in the middle of a commit leaves them
+void append_junk(const fc::path& file, size_t size)
+{
+    std::ofstream out(file.generic_string(), std::ios::binary | std::ios::app);
+    out << std::string(size, '\xff');
+}
+}
+
+BOOST_AUTO_TEST_SUITE(async_indexer_tests)
+
+SCORUM_TEST_CASE(blocks_are_consumed_in_order)
+{
+    std::vector<uint32_t> blocks;
+    size_t operations = 0;
+
+    async_indexer indexer;
+    indexer.add_consumer("test",
+                         [&](const indexed_block& block) {
+                             blocks.push_back(block.block_num);
+                             operations += block.operations.size();
+                         },
+                         [&](uint32_t) {});
+
+    for (uint32_t block_num = 1; block_num <= 5; ++block_num)
+    {
+        apply_block(indexer, block_num, { vote_operation(), transfer_operation() });
+    }
+
+    indexer.wait();
+
+    BOOST_CHECK_EQUAL(blocks.size(), 5u);
+    BOOST_CHECK(std::is_sorted(blocks.begin(), blocks.end()));
+    BOOST_CHECK_EQUAL(operations, 10u);
+    BOOST_CHECK_EQUAL(indexer.get_indexed_block_num(), 5u);
+}
+
+SCORUM_TEST_CASE(operations_of_aborted_block_are_dropped)
+{
+    std::vector<uint32_t> blocks;
+
+    async_indexer indexer;
+    indexer.add_consumer("test", [&](const indexed_block& block) { blocks.push_back(block.block_num); },
+                         [&](uint32_t) {});
+
+    indexer.begin_block(1, block_id_type(), fc::time_point_sec());
+    indexer.abort_block();
+    BOOST_CHECK(!indexer.is_collecting());
+
+    indexer.end_block(0);
+    indexer.wait();
+
+    BOOST_CHECK(blocks.empty());
+}
+
+SCORUM_TEST_CASE(consumers_roll_back_popped_blocks)
+{
+    std::vector<uint32_t> blocks;
+    std::vector<uint32_t> rollbacks;
+
+    async_indexer indexer;
+    indexer.add_consumer("test", [&](const indexed_block& block) { blocks.push_back(block.block_num); },
+                         [&](uint32_t block_num) { rollbacks.push_back(block_num); });
+
+    apply_block(indexer, 1, {});
+    apply_block(indexer, 2, {});
+    indexer.wait();
+
+    indexer.pop_block(1);
+    apply_block(indexer, 2, {});
+    indexer.wait();
+
+    BOOST_REQUIRE_EQUAL(rollbacks.size(), 1u);
+    BOOST_CHECK_EQUAL(rollbacks[0], 1u);
+    BOOST_CHECK_EQUAL(blocks.size(), 3u);
+    BOOST_CHECK_EQUAL(indexer.get_stats().rollbacks, 1u);
+    BOOST_CHECK_EQUAL(indexer.get_indexed_block_num(), 2u);
+}
+
+SCORUM_TEST_CASE(no_operations_are_collected_without_consumers)
+{
+    async_indexer indexer;
+
+    indexer.begin_block(1, block_id_type(), fc::time_point_sec());
+    BOOST_CHECK(!indexer.is_collecting());
+}
+
+SCORUM_TEST_CASE(history_store_keeps_account_sequences)
+{
+    history_store store;
+
+    store.append(make_operation(1, "alice"), { "alice", "bob" });
+    store.append(make_operation(2, "alice"), { "alice" });
+    store.append(make_operation(3, "bob"), { "bob" });
+    store.set_head_block_num(3);
+
+    auto history = store.get_account_history("alice", uint64_t(-1), 10);
+    BOOST_REQUIRE_EQUAL(history.size(), 2u);
+    BOOST_CHECK_EQUAL(history[0].block, 1u);
+    BOOST_CHECK_EQUAL(history[1].block, 2u);
+
+    history = store.get_account_history("bob", 1, 0);
+    BOOST_REQUIRE_EQUAL(history.size(), 1u);
+    BOOST_CHECK_EQUAL(history[1].block, 3u);
+
+    BOOST_CHECK_EQUAL(store.get_ops_in_block(2).size(), 1u);
+    BOOST_CHECK(store.get_account_history("sam", uint64_t(-1), 10).empty());
+
+    store.pop_blocks(1);
+
+    BOOST_CHECK_EQUAL(store.head_block_num(), 1u);
+    BOOST_CHECK_EQUAL(store.get_account_history("alice", uint64_t(-1), 10).size(), 1u);
+    BOOST_CHECK_EQUAL(store.get_account_history("bob", uint64_t(-1), 10).size(), 1u);
+    BOOST_CHECK(store.get_ops_in_block(3).empty());
+}
+
+SCORUM_TEST_CASE(committed_history_is_read_from_files)
+{
+    fc::path dir = graphene::utilities::temp_directory_path() / "history_store_test";
+    fc::remove_all(dir);
+
+    {
+        history_store store(history_store::default_operations_per_segment, 1);
+        store.open(dir);
+
+        for (uint32_t block_num = 1; block_num <= 10; ++block_num)
+        {
+            indexed_operation op = make_operation(block_num, "alice");
+            op.trx_id = transaction_id_type::hash(std::to_string(block_num));
+            store.append(op, { "alice" });
+            store.set_head_block_num(block_num);
+            store.commit(block_num - 1);
+        }
+
+        BOOST_CHECK_EQUAL(store.committed_block_num(), 9u);
+
+        // the last block can still be popped
+        store.pop_blocks(9);
+        BOOST_CHECK_EQUAL(store.head_block_num(), 9u);
+
+        store.append(make_operation(10, "alice"), { "alice", "bob" });
+        store.set_head_block_num(10);
+        store.commit(9);
+        store.flush();
+    }
+
+    history_store store;
+    store.open(dir);
+
+    BOOST_CHECK_EQUAL(store.committed_block_num(), 9u);
+    BOOST_CHECK_EQUAL(store.head_block_num(), 10u);
+
+    auto history = store.get_account_history("alice", uint64_t(-1), 100);
+    BOOST_REQUIRE_EQUAL(history.size(), 10u);
+    for (uint32_t sequence = 0; sequence < 10; ++sequence)
+    {
+        BOOST_CHECK_EQUAL(history[sequence].block, sequence + 1);
+    }
+
+    BOOST_CHECK_EQUAL(store.get_account_history("bob", uint64_t(-1), 100).size(), 1u);
+    BOOST_CHECK_EQUAL(store.get_ops_in_block(5).size(), 1u);
+
+    auto op = store.find_transaction(transaction_id_type::hash(std::to_string(5)));
+    BOOST_REQUIRE(op.valid());
+    BOOST_CHECK_EQUAL(op->block, 5u);
+    BOOST_CHECK(!store.find_transaction(transaction_id_type::hash(std::to_string(10))).valid());
+
+    fc::remove_all(dir);
+}
+
+SCORUM_TEST_CASE(uncommitted_records_are_dropped_on_open)
+{
+    fc::path dir = graphene::utilities::temp_directory_path() / "history_store_junk_test";
+    fc::remove_all(dir);
+
+    const uint64_t operations_per_segment = 4;
+
+    {
+        history_store store(operations_per_segment, 1);
+        store.open(dir);
+
+        for (uint32_t block_num = 1; block_num <= 10; ++block_num)
+        {
+            append_block(store, block_num);
+        }
+    }
+
+    // 9 operations are committed, the third segment has one of them
+    append_junk(dir / "operations.index", 100);
+    append_junk(dir / "transactions.index", 100);
+    append_junk(dir / "operations.000002.log", 100);
+    append_junk(dir / "operations.000003.log", 100);
+    append_junk(dir / "accounts" / "alice.index", 8);
+
+    {
+        history_store store(operations_per_segment, 1);
+        store.open(dir);
+
+        BOOST_CHECK_EQUAL(store.committed_block_num(), 9u);
+        BOOST_CHECK(!fc::exists(dir / "operations.000003.log"));
+
+        // the next commits roll over to new segments
+        for (uint32_t block_num = 11; block_num <= 14; ++block_num)
+        {
+            append_block(store, block_num);
+        }
+
+        BOOST_CHECK_EQUAL(store.committed_block_num(), 13u);
+    }
+
+    append_junk(dir / "operations.index", 10);
+    append_junk(dir / "operations.000003.log", 10);
+
+    history_store store(operations_per_segment, 1);
+    store.open(dir);
+
+    BOOST_CHECK_EQUAL(store.committed_block_num(), 13u);
+    BOOST_CHECK_EQUAL(store.head_block_num(), 14u);
+
+    auto history = store.get_account_history("alice", uint64_t(-1), 100);
+    BOOST_REQUIRE_EQUAL(history.size(), 14u);
+    for (uint32_t sequence = 0; sequence < 14; ++sequence)
+    {
+        BOOST_CHECK_EQUAL(history[sequence].block, sequence + 1);
+    }
+
+    for (uint32_t block_num = 1; block_num <= 14; ++block_num)
+    {
+        BOOST_CHECK_EQUAL(store.get_ops_in_block(block_num).size(), 1u);
+
+        auto op = store.find_transaction(transaction_id_type::hash(std::to_string(block_num)));
+        BOOST_REQUIRE(op.valid());
+        BOOST_CHECK_EQUAL(op->block, block_num);
+    }
+
+    fc::remove_all(dir);
+}
+
+SCORUM_TEST_CASE(open_fails_if_committed_records_are_missing)
+{
+    fc::path dir = graphene::utilities::temp_directory_path() / "history_store_short_test";
+    fc::remove_all(dir);
+
+    const uint64_t operations_per_segment = 4;
+
+    {
+        history_store store(operations_per_segment, 1);
+        store.open(dir);
+
+        for (uint32_t block_num = 1; block_num <= 7; ++block_num)
+        {
+            append_block(store, block_num);
+        }
+    }
+
+    // the second segment has 2 committed operations
+    fc::path segment = dir / "operations.000001.log";
+    boost::filesystem::resize_file(segment.generic_string(), fc::file_size(segment) - 1);
+
+    history_store store(operations_per_segment, 1);
+    BOOST_REQUIRE_THROW(store.open(dir), fc::assert_exception);
+
+    fc::remove_all(dir);
+}
+
+SCORUM_TEST_CASE(irreversible_blocks_are_written_in_batches)
+{
+    fc::path dir = graphene::utilities::temp_directory_path() / "history_store_batch_test";
+    fc::remove_all(dir);
+
+    {
+        history_store store(history_store::default_operations_per_segment, 5);
+        store.open(dir);
+
+        for (uint32_t block_num = 1; block_num <= 7; ++block_num)
+        {
+            append_block(store, block_num);
+        }
+
+        BOOST_CHECK_EQUAL(store.committed_block_num(), 5u);
+        BOOST_CHECK_EQUAL(store.get_account_history("alice", uint64_t(-1), 100).size(), 7u);
+
+        store.flush();
+        BOOST_CHECK_EQUAL(store.committed_block_num(), 6u);
+
+        append_block(store, 8);
+    }
+
+    // the block after the last write is indexed again on replay
+    history_store store(history_store::default_operations_per_segment, 5);
+    store.open(dir);
+
+    BOOST_CHECK_EQUAL(store.committed_block_num(), 6u);
+    BOOST_CHECK_EQUAL(store.head_block_num(), 7u);
+    BOOST_CHECK_EQUAL(store.get_account_history("alice", uint64_t(-1), 100).size(), 7u);
+
+    fc::remove_all(dir);
+}
+
+SCORUM_TEST_CASE(records_of_failed_write_are_truncated)
+{
+    fc::path dir = graphene::utilities::temp_directory_path() / "history_store_failed_test";
+    fc::remove_all(dir);
+
+    {
+        history_store store(history_store::default_operations_per_segment, 1);
+        store.open(dir);
+
+        append_block(store, 1);
+
+        store.append(make_operation(2, "bob"), { "alice", "bob" });
+        store.set_head_block_num(2);
+
+        // the account file of bob can not be written
+        fc::create_directories(dir / "accounts" / "bob.index");
+        BOOST_REQUIRE_THROW(store.commit(2), fc::exception);
+
+        BOOST_CHECK_EQUAL(store.committed_block_num(), 0u);
+        BOOST_CHECK_EQUAL(fc::file_size(dir / "operations.index"), 0u);
+        BOOST_CHECK_EQUAL(fc::file_size(dir / "accounts" / "alice.index"), 0u);
+
+        fc::remove_all(dir / "accounts" / "bob.index");
+        store.commit(2);
+
+        BOOST_CHECK_EQUAL(store.committed_block_num(), 2u);
+    }
+
+    history_store store;
+    store.open(dir);
+
+    auto history = store.get_account_history("alice", uint64_t(-1), 100);
+    BOOST_REQUIRE_EQUAL(history.size(), 2u);
+    BOOST_CHECK_EQUAL(history[0].block, 1u);
+    BOOST_CHECK_EQUAL(history[1].block, 2u);
+
+    history = store.get_account_history("bob", uint64_t(-1), 100);
+    BOOST_REQUIRE_EQUAL(history.size(), 1u);
+    BOOST_CHECK_EQUAL(history[0].block, 2u);
+
+    fc::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/services/account.hpp>
+
+#include <scorum/chain/schema/account_objects.hpp>
+#include <scorum/chain/schema/atomicswap_objects.hpp>
+#include <scorum/chain/schema/dynamic_global_property_object.hpp>
+
+#include <scorum/protocol/atomicswap_helper.hpp>
+
+#include "database_fixture.hpp"
+
+using namespace scorum;
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+//
+// usage for all budget tests 'chain_test  -t atomicswap_*'
+//
+
+class atomicswap_expiration_fixture : public clean_database_fixture
+{
+public:
+    atomicswap_expiration_fixture()
+        : account_service(db.obtain_service<dbs_account>())
+    {
+    }
+
+    // contracts are created directly to bypass per owner and per recipient limits
+    void create_contracts(uint32_t count, fc::time_point_sec deadline, const std::string& prefix)
+    {
+        const account_object& owner = account_service.get_account(TEST_INIT_DELEGATE_NAME);
+        const asset locked(CONTRACT_AMOUNT.amount.value * count, SCORUM_SYMBOL);
+
+        account_service.decrease_balance(owner, locked);
+        db.modify(db.get_dynamic_global_properties(),
+                  [&](dynamic_global_property_object& props) { props.total_atomicswap_balance += locked; });
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            std::string secret = prefix + fc::to_string(i);
+            std::string secret_hash = atomicswap::get_secret_hash(fc::to_hex(secret.data(), secret.size()));
+
+            db.create<atomicswap_contract_object>([&](atomicswap_contract_object& contract) {
+                contract.type = atomicswap_contract_initiator;
+                contract.owner = owner.name;
+                contract.to = owner.name;
+                contract.amount = CONTRACT_AMOUNT;
+                contract.created = db.head_block_time();
+                contract.deadline = deadline;
+                fc::from_string(contract.secret_hash, secret_hash);
+                contract.contract_hash = atomicswap::get_contract_hash(owner.name, owner.name, secret_hash);
+            });
+        }
+    }
+
+    size_t contracts_count() const
+    {
+        return db.get_index<atomicswap_contract_index>().indices().size();
+    }
+
+    dbs_account& account_service;
+
+    const asset CONTRACT_AMOUNT = asset(1, SCORUM_SYMBOL);
+};
+
+BOOST_FIXTURE_TEST_SUITE(atomicswap_expiration_check, atomicswap_expiration_fixture)
+
+SCORUM_TEST_CASE(expire_only_due_contracts)
+{
+    const fc::time_point_sec far_deadline = db.head_block_time() + fc::days(365);
+    create_contracts(10, far_deadline, "far");
+
+    const fc::time_point_sec near_deadline = db.head_block_time() + SCORUM_BLOCK_INTERVAL * 3;
+    create_contracts(5, near_deadline, "near");
+
+    const asset balance = db.get_balance(TEST_INIT_DELEGATE_NAME, SCORUM_SYMBOL);
+    const uint64_t processed = db.get_due_events().processed(atomicswap_contract_expiration);
+
+    generate_blocks(near_deadline - SCORUM_BLOCK_INTERVAL);
+    BOOST_REQUIRE_EQUAL(contracts_count(), 15u);
+
+    generate_blocks(near_deadline);
+    BOOST_REQUIRE_EQUAL(contracts_count(), 10u);
+    BOOST_CHECK_EQUAL(db.get_due_events().processed(atomicswap_contract_expiration), processed + 5);
+    BOOST_CHECK(db.get_balance(TEST_INIT_DELEGATE_NAME, SCORUM_SYMBOL) >= balance + asset(CONTRACT_AMOUNT.amount.value * 5, SCORUM_SYMBOL));
+
+    const auto& idx = db.get_index<atomicswap_contract_index>().indices().get<by_deadline>();
+    BOOST_CHECK(idx.begin()->deadline == far_deadline);
+
+    validate_database();
+}
+
+SCORUM_TEST_CASE(open_contracts_are_not_visited_before_deadline)
+{
+    const uint32_t open_contracts = 1000;
+    create_contracts(open_contracts, db.head_block_time() + fc::days(365), "open");
+    BOOST_REQUIRE_EQUAL(contracts_count(), open_contracts);
+
+    const uint64_t processed = db.get_due_events().processed(atomicswap_contract_expiration);
+
+    generate_blocks(20);
+
+    // expiration costs depend on due contracts only, no open contract was visited
+    BOOST_CHECK_EQUAL(db.get_due_events().processed(atomicswap_contract_expiration), processed);
+    BOOST_CHECK_EQUAL(contracts_count(), open_contracts);
+
+    validate_database();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
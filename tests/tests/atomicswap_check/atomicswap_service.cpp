@@ -34,8 +34,8 @@ public:
         , bob(account_service.create_account(
               "bob", "initdelegate", public_key, "", authority(), authority(), authority(), ASSET_NULL_SCR))
     {
-        account_service.increase_balance(alice, ALICE_BALANCE);
-        account_service.increase_balance(bob, BOB_BALANCE);
+        fund_directly(alice, ALICE_BALANCE);
+        fund_directly(bob, BOB_BALANCE);
 
         for (int ci = 0; ci < SCORUM_ATOMICSWAP_LIMIT_REQUESTED_CONTRACTS_PER_OWNER + 1; ++ci)
         {
@@ -44,13 +44,20 @@ public:
             account_name_type next_name = store.str();
             const account_object& man = account_service.create_account(
                 next_name, "initdelegate", public_key, "", authority(), authority(), authority(), ASSET_NULL_SCR);
-            account_service.increase_balance(man, MAN_BALANCE);
+            fund_directly(man, MAN_BALANCE);
             people.push_back(next_name);
         }
 
         alice_secret_hash = atomicswap::get_secret_hash(ALICE_SECRET);
     }
 
+    // balance is moved from the initial delegate, so the supply stays the same
+    void fund_directly(const account_object& account, const asset& amount)
+    {
+        account_service.decrease_balance(account_service.get_account(TEST_INIT_DELEGATE_NAME), amount);
+        account_service.increase_balance(account, amount);
+    }
+
     dbs_atomicswap& atomicswap_service;
     dbs_account& account_service;
 
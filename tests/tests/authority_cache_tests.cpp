@@ -0,0 +1,82 @@
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/authority_cache.hpp>
+
+#include "defines.hpp"
+
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+namespace {
+
+struct authority_cache_fixture
+{
+    authority_cache_fixture()
+    {
+        cache.enable();
+    }
+
+    authority_cache::loader_type loader(uint32_t threshold)
+    {
+        return [this, threshold]() {
+            ++loads;
+            authority result;
+            result.weight_threshold = threshold;
+            return result;
+        };
+    }
+
+    authority_cache cache;
+    uint32_t loads = 0;
+};
+}
+
+BOOST_FIXTURE_TEST_SUITE(authority_cache_tests, authority_cache_fixture)
+
+SCORUM_TEST_CASE(authority_is_loaded_once)
+{
+    BOOST_CHECK_EQUAL(cache.get("alice", authority_cache::active, loader(1))->weight_threshold, 1u);
+    BOOST_CHECK_EQUAL(cache.get("alice", authority_cache::active, loader(2))->weight_threshold, 1u);
+    BOOST_CHECK_EQUAL(loads, 1u);
+
+    BOOST_CHECK_EQUAL(cache.get("alice", authority_cache::posting, loader(3))->weight_threshold, 3u);
+    BOOST_CHECK_EQUAL(cache.get("bob", authority_cache::active, loader(4))->weight_threshold, 4u);
+    BOOST_CHECK_EQUAL(loads, 3u);
+}
+
+SCORUM_TEST_CASE(invalidated_account_is_reloaded)
+{
+    cache.get("alice", authority_cache::active, loader(1));
+    cache.get("alice", authority_cache::owner, loader(1));
+    cache.get("bob", authority_cache::active, loader(1));
+
+    cache.invalidate("alice");
+
+    BOOST_CHECK_EQUAL(cache.get("alice", authority_cache::active, loader(2))->weight_threshold, 2u);
+    BOOST_CHECK_EQUAL(cache.get("alice", authority_cache::owner, loader(2))->weight_threshold, 2u);
+    BOOST_CHECK_EQUAL(cache.get("bob", authority_cache::active, loader(2))->weight_threshold, 1u);
+    BOOST_CHECK_EQUAL(loads, 5u);
+}
+
+SCORUM_TEST_CASE(cache_is_dropped_on_disable)
+{
+    cache.get("alice", authority_cache::active, loader(1));
+
+    cache.disable();
+    BOOST_CHECK(!cache.enabled());
+
+    cache.enable();
+    BOOST_CHECK_EQUAL(cache.get("alice", authority_cache::active, loader(2))->weight_threshold, 2u);
+}
+
+SCORUM_TEST_CASE(cached_authority_outlives_invalidation)
+{
+    auto cached = cache.get("alice", authority_cache::active, loader(1));
+
+    cache.invalidate("alice");
+
+    BOOST_CHECK_EQUAL(cache.get("alice", authority_cache::active, loader(2))->weight_threshold, 2u);
+    BOOST_CHECK_EQUAL(cached->weight_threshold, 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
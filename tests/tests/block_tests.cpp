@@ -28,6 +28,7 @@
 #include <scorum/protocol/exceptions.hpp>
 
 #include <scorum/chain/database.hpp>
+#include <scorum/chain/block_log.hpp>
 #include <scorum/chain/schema/scorum_objects.hpp>
 #include <scorum/chain/schema/history_objects.hpp>
 #include <scorum/chain/genesis_state.hpp>
@@ -38,6 +39,8 @@
 
 #include <fc/crypto/digest.hpp>
 
+#include <fstream>
+
 #include "database_fixture.hpp"
 
 using namespace scorum;
@@ -170,6 +173,283 @@ BOOST_AUTO_TEST_CASE(undo_block)
     }
 }
 
+BOOST_AUTO_TEST_CASE(block_cache_follows_main_chain)
+{
+    try
+    {
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        {
+            database db;
+            db_setup_and_open(db, data_dir.path());
+            db.set_block_cache_size(3);
+
+            auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(std::string(TEST_INIT_KEY)));
+            std::vector<block_id_type> ids;
+            for (uint32_t i = 0; i < 5; ++i)
+            {
+                auto b = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                           database::skip_nothing);
+                ids.push_back(b.id());
+            }
+
+            auto stats = db.get_block_cache_stats();
+            BOOST_CHECK_EQUAL(stats.size, 3u);
+            BOOST_CHECK_EQUAL(stats.capacity, 3u);
+
+            BOOST_REQUIRE(db.fetch_block_by_number(5).valid());
+            BOOST_CHECK(db.fetch_block_by_number(5)->id() == ids[4]);
+            BOOST_REQUIRE(db.fetch_block_by_id(ids[3]).valid());
+            BOOST_CHECK_EQUAL(db.get_block_cache_stats().hits, stats.hits + 3);
+
+            // cache hits share the cached block
+            auto shared = db.fetch_shared_block_by_number(5);
+            BOOST_REQUIRE(shared);
+            BOOST_CHECK(shared == db.fetch_shared_block_by_id(ids[4]));
+
+            db.pop_block();
+            BOOST_CHECK_EQUAL(db.get_block_cache_stats().size, 2u);
+
+            auto b = db.generate_block(db.get_slot_time(2), db.get_scheduled_witness(2), init_account_priv_key,
+                                       database::skip_nothing);
+            BOOST_REQUIRE(b.id() != ids[4]);
+            BOOST_REQUIRE(db.fetch_block_by_number(5).valid());
+            BOOST_CHECK(db.fetch_block_by_number(5)->id() == b.id());
+
+            db.set_block_cache_size(0);
+            BOOST_CHECK_EQUAL(db.get_block_cache_stats().size, 0u);
+            BOOST_REQUIRE(db.fetch_block_by_number(4).valid());
+            BOOST_CHECK(db.fetch_block_by_number(4)->id() == ids[3]);
+        }
+    }
+    catch (fc::exception& e)
+    {
+        edump((e.to_detail_string()));
+        throw;
+    }
+}
+
+std::vector<signed_block> append_unsigned_blocks(block_log& log, uint32_t count)
+{
+    std::vector<signed_block> blocks;
+
+    block_id_type previous;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        signed_block b;
+        b.previous = previous;
+        b.timestamp = fc::time_point_sec(TEST_GENESIS_TIMESTAMP) + i * SCORUM_BLOCK_INTERVAL;
+        b.witness = TEST_INIT_DELEGATE_NAME;
+        if (i % 3 == 0)
+        {
+            b.transactions.emplace_back(signed_transaction());
+            b.transaction_merkle_root = b.calculate_merkle_root();
+        }
+        log.append(b);
+        previous = b.id();
+        blocks.push_back(b);
+    }
+    log.flush();
+
+    return blocks;
+}
+
+BOOST_AUTO_TEST_CASE(block_log_header_index)
+{
+    try
+    {
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        fc::path log_file = data_dir.path() / "block_log";
+
+        std::vector<signed_block> blocks;
+        {
+            block_log log;
+            log.open(log_file);
+            blocks = append_unsigned_blocks(log, 10);
+        }
+
+        auto check_headers = [&](const block_log& log) {
+            for (const signed_block& b : blocks)
+            {
+                auto r = log.read_header_record_by_num(b.block_num());
+                BOOST_REQUIRE(r.valid());
+                BOOST_CHECK(r->id == b.id());
+                BOOST_CHECK(r->previous == b.previous);
+                BOOST_CHECK(r->timestamp == b.timestamp);
+                BOOST_CHECK_EQUAL(r->witness, b.witness);
+                BOOST_CHECK_EQUAL(r->transaction_count, b.transactions.size());
+
+                auto h = log.read_header_by_num(b.block_num());
+                BOOST_REQUIRE(h.valid());
+                BOOST_CHECK(h->digest() == b.digest());
+            }
+            BOOST_CHECK(!log.read_header_record_by_num(blocks.size() + 1).valid());
+
+            auto range = log.read_header_records_by_time(blocks[2].timestamp, blocks[6].timestamp, 100);
+            BOOST_REQUIRE_EQUAL(range.size(), 4u);
+            BOOST_CHECK(range.front().id == blocks[2].id());
+            BOOST_CHECK(range.back().id == blocks[5].id());
+
+            BOOST_CHECK_EQUAL(log.read_header_records_by_time(blocks[2].timestamp, blocks[6].timestamp, 2).size(), 2u);
+        };
+
+        {
+            block_log log;
+            log.open(log_file);
+            check_headers(log);
+        }
+
+        BOOST_TEST_MESSAGE("Header index is rebuilt from the block log");
+        fc::remove_all(data_dir.path() / "block_log.headers");
+        {
+            block_log log;
+            log.open(log_file);
+            check_headers(log);
+        }
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(block_log_segments)
+{
+    try
+    {
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        fc::path log_file = data_dir.path() / "block_log";
+
+        std::vector<signed_block> blocks;
+        {
+            block_log log;
+            log.open(log_file, 4);
+            blocks = append_unsigned_blocks(log, 10);
+        }
+
+        BOOST_CHECK(fc::exists(data_dir.path() / "block_log.manifest"));
+        BOOST_CHECK(fc::exists(data_dir.path() / "block_log.0000000005"));
+        BOOST_CHECK(fc::exists(data_dir.path() / "block_log.0000000009"));
+
+        BOOST_TEST_MESSAGE("Segment indexes are rebuilt on open");
+        fc::remove_all(data_dir.path() / "block_log.0000000005.index");
+        fc::remove_all(data_dir.path() / "block_log.headers");
+        {
+            block_log log;
+            log.open(log_file, 4);
+
+            BOOST_CHECK_EQUAL(log.first_block_num(), 1u);
+            BOOST_REQUIRE(log.head().valid());
+            BOOST_CHECK(log.head()->id() == blocks.back().id());
+            for (const signed_block& b : blocks)
+            {
+                auto read = log.read_block_by_num(b.block_num());
+                BOOST_REQUIRE(read.valid());
+                BOOST_CHECK(read->id() == b.id());
+                BOOST_CHECK(log.read_header_record_by_num(b.block_num())->id == b.id());
+            }
+
+            auto verified = log.verify(2);
+            BOOST_CHECK(verified.errors.empty());
+            BOOST_CHECK_EQUAL(verified.verified_blocks, 10u);
+
+            BOOST_TEST_MESSAGE("Only whole segments are pruned");
+            BOOST_CHECK_EQUAL(log.prune(6), 4u);
+            BOOST_CHECK_EQUAL(log.first_block_num(), 5u);
+            BOOST_CHECK(!log.read_block_by_num(4).valid());
+            BOOST_CHECK(log.read_block_by_num(5).valid());
+            BOOST_CHECK(!fc::exists(log_file));
+
+            BOOST_TEST_MESSAGE("The last segment is never pruned");
+            BOOST_CHECK_EQUAL(log.prune(100), 4u);
+            BOOST_CHECK_EQUAL(log.first_block_num(), 9u);
+            BOOST_CHECK(log.read_block_by_num(10).valid());
+        }
+        {
+            block_log log;
+            log.open(log_file, 4);
+            BOOST_CHECK_EQUAL(log.first_block_num(), 9u);
+            BOOST_REQUIRE(log.head().valid());
+            BOOST_CHECK(log.head()->id() == blocks.back().id());
+        }
+
+        block_log::remove_files(log_file);
+        BOOST_CHECK(!fc::exists(data_dir.path() / "block_log.manifest"));
+        BOOST_CHECK(!fc::exists(data_dir.path() / "block_log.0000000009"));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+void overwrite_file(const fc::path& file, uint64_t offset, const char* data, size_t size)
+{
+    std::fstream f(file.generic_string().c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(offset);
+    f.write(data, size);
+}
+
+BOOST_AUTO_TEST_CASE(block_log_verify_reports_corruption)
+{
+    try
+    {
+        fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+        fc::path log_file = data_dir.path() / "block_log";
+
+        {
+            block_log log;
+            log.open(log_file);
+            append_unsigned_blocks(log, 10);
+        }
+
+        BOOST_TEST_MESSAGE("Wrong id in the header index");
+        {
+            block_id_type wrong_id = fc::ripemd160::hash(std::string("wrong"));
+            overwrite_file(data_dir.path() / "block_log.headers", block_log::header_record_size * 3, wrong_id.data(),
+                           wrong_id.data_size());
+
+            block_log log;
+            log.open(log_file);
+
+            auto verified = log.verify(2);
+            BOOST_REQUIRE_EQUAL(verified.errors.size(), 1u);
+            BOOST_CHECK_EQUAL(verified.errors[0], "block 4: id does not match header index");
+            BOOST_CHECK_EQUAL(verified.verified_blocks, 3u);
+        }
+
+        BOOST_TEST_MESSAGE("Wrong position in the block index");
+        fc::remove_all(data_dir.path() / "block_log.headers");
+        {
+            block_log log;
+            log.open(log_file);
+            BOOST_REQUIRE(log.verify(2).errors.empty());
+
+            uint64_t pos = log.get_block_pos(6);
+            log.close();
+            overwrite_file(data_dir.path() / "block_log.index", sizeof(uint64_t) * 6, (const char*)&pos, sizeof(pos));
+        }
+        {
+            block_log log;
+            log.open(log_file);
+
+            auto verified = log.verify(2);
+            BOOST_REQUIRE_EQUAL(verified.errors.size(), 1u);
+            BOOST_CHECK_EQUAL(verified.errors[0], "block 7: wrong block number 6");
+            BOOST_CHECK_EQUAL(verified.verified_blocks, 6u);
+        }
+
+        BOOST_TEST_MESSAGE("Garbage position in the block index");
+        {
+            uint64_t pos = fc::file_size(log_file) + 1000;
+            overwrite_file(data_dir.path() / "block_log.index", sizeof(uint64_t) * 6, (const char*)&pos, sizeof(pos));
+
+            block_log log;
+            log.open(log_file);
+
+            block_log_verify_result verified;
+            BOOST_REQUIRE_NO_THROW(verified = log.verify(2));
+            BOOST_REQUIRE_EQUAL(verified.errors.size(), 1u);
+            BOOST_CHECK_EQUAL(verified.errors[0].find("block 7: "), 0u);
+            BOOST_CHECK_EQUAL(verified.verified_blocks, 6u);
+        }
+    }
+    FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE(fork_blocks)
 {
     try
@@ -547,6 +827,400 @@ BOOST_FIXTURE_TEST_CASE(double_sign_check, clean_database_fixture)
     FC_LOG_AND_RETHROW()
 }
 
+BOOST_FIXTURE_TEST_CASE(pending_transactions_reapply, clean_database_fixture)
+{
+    try
+    {
+        ACTORS((alice)(bob))
+        fund("alice", 10000);
+        generate_block();
+
+        auto make_transfer = [&](const std::string& from, const std::string& to, const fc::ecc::private_key& key) {
+            transfer_operation op;
+            op.from = from;
+            op.to = to;
+            op.amount = asset(100, SCORUM_SYMBOL);
+
+            signed_transaction tx;
+            tx.operations.push_back(op);
+            tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(key, db.get_chain_id());
+            return tx;
+        };
+
+        auto b = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                   database::skip_nothing);
+        db.pop_block();
+
+        signed_transaction alice_tx = make_transfer("alice", "bob", alice_private_key);
+        signed_transaction init_tx = make_transfer(TEST_INIT_DELEGATE_NAME, "bob", init_account_priv_key);
+        db.push_transaction(alice_tx, 0);
+        db.push_transaction(init_tx, 0);
+
+        auto stats = db.get_mempool_stats();
+        BOOST_CHECK_EQUAL(stats.pending, 2u);
+
+        BOOST_TEST_MESSAGE("--- Test transactions are re-applied without checks after a block on top of head");
+        db.push_block(b, 0);
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().pending, 2u);
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().reapplied, stats.reapplied + 2);
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().revalidated, stats.revalidated);
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().dropped, stats.dropped);
+
+        BOOST_TEST_MESSAGE("--- Test transactions are revalidated after a block updating their authorities");
+        db.clear_pending();
+
+        private_key_type new_private_key = generate_private_key("new_key");
+
+        account_update_operation op;
+        op.account = "alice";
+        op.active = authority(1, new_private_key.get_public_key(), 1);
+
+        signed_transaction update_tx;
+        update_tx.operations.push_back(op);
+        update_tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+        update_tx.sign(alice_private_key, db.get_chain_id());
+        db.push_transaction(update_tx, 0);
+
+        auto c = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                   database::skip_nothing);
+        BOOST_REQUIRE_EQUAL(c.transactions.size(), 1u);
+        db.pop_block();
+
+        db.push_transaction(alice_tx, 0);
+        db.push_transaction(init_tx, 0);
+
+        stats = db.get_mempool_stats();
+        db.push_block(c, 0);
+
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().pending, 1u);
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().reapplied, stats.reapplied + 1);
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().dropped, stats.dropped + 1);
+        BOOST_CHECK(!db.is_known_transaction(alice_tx.id()));
+        BOOST_CHECK(db.is_known_transaction(init_tx.id()));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE(pending_transactions_verified_against_dropped_update, clean_database_fixture)
+{
+    try
+    {
+        ACTORS((alice)(bob))
+        fund("alice", 10000);
+        generate_block();
+
+        auto make_transfer = [&](share_type amount, const fc::ecc::private_key& key) {
+            transfer_operation op;
+            op.from = "alice";
+            op.to = "bob";
+            op.amount = asset(amount, SCORUM_SYMBOL);
+
+            signed_transaction tx;
+            tx.operations.push_back(op);
+            tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(key, db.get_chain_id());
+            return tx;
+        };
+
+        db.push_transaction(make_transfer(9000, alice_private_key), 0);
+        auto b = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                   database::skip_nothing);
+        BOOST_REQUIRE_EQUAL(b.transactions.size(), 1u);
+        db.pop_block();
+        db.clear_pending();
+
+        private_key_type new_private_key = generate_private_key("new_key");
+
+        account_update_operation update;
+        update.account = "alice";
+        update.active = authority(1, new_private_key.get_public_key(), 1);
+
+        transfer_operation transfer;
+        transfer.from = "alice";
+        transfer.to = "bob";
+        transfer.amount = asset(5000, SCORUM_SYMBOL);
+
+        signed_transaction update_tx;
+        update_tx.operations.push_back(update);
+        update_tx.operations.push_back(transfer);
+        update_tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+        update_tx.sign(alice_private_key, db.get_chain_id());
+        db.push_transaction(update_tx, 0);
+
+        signed_transaction new_key_tx = make_transfer(100, new_private_key);
+        db.push_transaction(new_key_tx, 0);
+
+        BOOST_TEST_MESSAGE("--- Test transactions verified against an update which is dropped are revalidated");
+        auto stats = db.get_mempool_stats();
+        db.push_block(b, 0);
+
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().pending, 0u);
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().reapplied, stats.reapplied);
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().dropped, stats.dropped + 2);
+        BOOST_CHECK(!db.is_known_transaction(update_tx.id()));
+        BOOST_CHECK(!db.is_known_transaction(new_key_tx.id()));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE(recent_transaction_lookup, clean_database_fixture)
+{
+    try
+    {
+        ACTORS((alice))
+        fund("alice", 10000);
+        generate_block();
+
+        transfer_operation op;
+        op.from = "alice";
+        op.to = TEST_INIT_DELEGATE_NAME;
+        op.amount = asset(100, SCORUM_SYMBOL);
+
+        signed_transaction tx;
+        tx.operations.push_back(op);
+        tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+        tx.sign(alice_private_key, db.get_chain_id());
+        db.push_transaction(tx, 0);
+
+        BOOST_TEST_MESSAGE("--- Test pending transaction is read from the pool");
+        BOOST_REQUIRE(db.get_recent_transaction(tx.id()).id() == tx.id());
+
+        BOOST_TEST_MESSAGE("--- Test included transaction is read from its block");
+        generate_block();
+        generate_block();
+        BOOST_REQUIRE(db.is_known_transaction(tx.id()));
+        BOOST_REQUIRE(db.get_recent_transaction(tx.id()).id() == tx.id());
+
+        BOOST_TEST_MESSAGE("--- Test expired transaction is forgotten");
+        generate_blocks(tx.expiration + SCORUM_BLOCK_INTERVAL);
+        BOOST_REQUIRE(!db.is_known_transaction(tx.id()));
+        BOOST_REQUIRE_THROW(db.get_recent_transaction(tx.id()), fc::exception);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE(block_authorities_are_verified_in_block_order, clean_database_fixture)
+{
+    try
+    {
+        ACTORS((alice)(bob))
+        fund("alice", 10000);
+        generate_block();
+
+        asset bob_balance = db.get_account("bob").balance;
+
+        auto make_transfer = [&](int64_t amount) {
+            transfer_operation op;
+            op.from = "alice";
+            op.to = "bob";
+            op.amount = asset(amount, SCORUM_SYMBOL);
+
+            signed_transaction tx;
+            tx.operations.push_back(op);
+            tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(alice_private_key, db.get_chain_id());
+            return tx;
+        };
+
+        // enough transactions to verify authorities in parallel
+        for (int64_t amount = 1; amount <= 8; ++amount)
+        {
+            db.push_transaction(make_transfer(amount), 0);
+        }
+
+        account_update_operation op;
+        op.account = "alice";
+        op.active = authority(1, generate_private_key("new_key").get_public_key(), 1);
+
+        signed_transaction update_tx;
+        update_tx.operations.push_back(op);
+        update_tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+        update_tx.sign(alice_private_key, db.get_chain_id());
+        db.push_transaction(update_tx, 0);
+
+        auto b = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                   database::skip_nothing);
+        BOOST_REQUIRE_EQUAL(b.transactions.size(), 9u);
+        db.pop_block();
+        db.clear_pending();
+
+        BOOST_TEST_MESSAGE("--- Test transaction signed with the key replaced earlier in the block is rejected");
+        signed_block bad = b;
+        bad.transactions.push_back(make_transfer(9));
+        bad.transaction_merkle_root = bad.calculate_merkle_root();
+        bad.sign(init_account_priv_key);
+        BOOST_REQUIRE_THROW(db.push_block(bad, 0), fc::exception);
+
+        BOOST_TEST_MESSAGE("--- Test transactions verified in parallel are applied");
+        BOOST_REQUIRE_NO_THROW(db.push_block(b, 0));
+        BOOST_REQUIRE_EQUAL(db.get_account("bob").balance.amount.value, bob_balance.amount.value + 36);
+
+        validate_database();
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE(prevalidate_block_stateless_checks, clean_database_fixture)
+{
+    try
+    {
+        ACTORS((alice))
+        fund("alice", 10000);
+        generate_block();
+
+        transfer_operation op;
+        op.from = "alice";
+        op.to = TEST_INIT_DELEGATE_NAME;
+        op.amount = asset(100, SCORUM_SYMBOL);
+
+        signed_transaction tx;
+        tx.operations.push_back(op);
+        tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+        tx.sign(alice_private_key, db.get_chain_id());
+        db.push_transaction(tx, 0);
+
+        auto b = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                   database::skip_nothing);
+        db.pop_block();
+        db.clear_pending();
+
+        const chain_id_type& chain_id = db.get_chain_id();
+
+        auto prevalidated = database::prevalidate_block(b, chain_id);
+        BOOST_CHECK_EQUAL(prevalidated.skip, (uint32_t)(database::skip_merkle_check | database::skip_validate));
+        BOOST_REQUIRE(prevalidated.signee.valid());
+        BOOST_CHECK(*prevalidated.signee == public_key_type(init_account_priv_key.get_public_key()));
+        BOOST_REQUIRE_EQUAL(prevalidated.signature_keys.size(), 1u);
+        BOOST_REQUIRE(prevalidated.signature_keys[0].valid());
+        BOOST_CHECK(prevalidated.signature_keys[0]->count(alice_public_key));
+
+        BOOST_TEST_MESSAGE("--- Test keys are not recovered for skipped signature checks");
+        auto unsigned_checks = database::prevalidate_block(
+            b, chain_id, database::skip_witness_signature | database::skip_transaction_signatures);
+        BOOST_CHECK(!unsigned_checks.signee.valid());
+        BOOST_REQUIRE_EQUAL(unsigned_checks.signature_keys.size(), 1u);
+        BOOST_CHECK(!unsigned_checks.signature_keys[0].valid());
+
+        BOOST_TEST_MESSAGE("--- Test block with wrong merkle root");
+        signed_block bad_merkle = b;
+        bad_merkle.transaction_merkle_root = checksum_type();
+        bad_merkle.sign(init_account_priv_key);
+        BOOST_CHECK_EQUAL(database::prevalidate_block(bad_merkle, chain_id).skip, (uint32_t)database::skip_validate);
+
+        BOOST_TEST_MESSAGE("--- Test block with validly signed transaction which fails validation");
+        signed_transaction invalid_tx = tx;
+        invalid_tx.operations[0].get<transfer_operation>().amount = asset(-100, SCORUM_SYMBOL);
+        invalid_tx.signatures.clear();
+        invalid_tx.sign(alice_private_key, chain_id);
+
+        signed_block bad_trx = b;
+        bad_trx.transactions[0] = invalid_tx;
+        bad_trx.transaction_merkle_root = bad_trx.calculate_merkle_root();
+        bad_trx.sign(init_account_priv_key);
+
+        auto bad_prevalidated = database::prevalidate_block(bad_trx, chain_id);
+        BOOST_CHECK_EQUAL(bad_prevalidated.skip, (uint32_t)database::skip_merkle_check);
+        BOOST_REQUIRE(bad_prevalidated.signature_keys[0].valid());
+        BOOST_CHECK(bad_prevalidated.signature_keys[0]->count(alice_public_key));
+
+        // signatures are not checked, so the block can only be rejected by validation
+        BOOST_REQUIRE_THROW(db.push_block(bad_trx, bad_prevalidated, database::skip_transaction_signatures),
+                            fc::assert_exception);
+        BOOST_REQUIRE(db.head_block_id() == b.previous);
+
+        BOOST_REQUIRE_NO_THROW(db.push_block(b, prevalidated));
+        BOOST_REQUIRE(db.head_block_id() == b.id());
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE(block_template_merkle_root)
+{
+    try
+    {
+        signed_block b;
+        block_template t;
+        t.reset(block_id_type());
+
+        BOOST_CHECK(t.merkle_root() == b.calculate_merkle_root());
+
+        for (uint32_t i = 0; i < 33; ++i)
+        {
+            signed_transaction tx;
+            tx.ref_block_num = (uint16_t)i;
+            tx.set_expiration(fc::time_point_sec(TEST_GENESIS_TIMESTAMP) + i);
+
+            b.transactions.push_back(tx);
+            t.push(pending_transaction(tx), 0);
+
+            BOOST_CHECK(t.merkle_root() == b.calculate_merkle_root());
+        }
+
+        BOOST_CHECK_EQUAL(t.size(), b.transactions.size());
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE(block_timing_stats, clean_database_fixture)
+{
+    try
+    {
+        generate_blocks(5);
+
+        auto stats = db.get_block_timing_stats();
+        BOOST_CHECK_EQUAL(stats.last_block_num, db.head_block_num());
+        BOOST_CHECK_GE(stats.window, 5u);
+        BOOST_REQUIRE_EQUAL(stats.phases.size(), (size_t)block_timer::phase_count);
+
+        uint64_t phases_us = 0;
+        for (const auto& phase : stats.phases)
+        {
+            BOOST_CHECK_LE(phase.p50_us, phase.p90_us);
+            BOOST_CHECK_LE(phase.p90_us, phase.p99_us);
+            BOOST_CHECK_LE(phase.p99_us, phase.max_us);
+            phases_us += phase.last_us;
+        }
+        BOOST_CHECK_LE(phases_us, stats.total.last_us);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE(generate_block_from_template, clean_database_fixture)
+{
+    try
+    {
+        ACTORS((alice))
+        generate_block();
+
+        auto alice_balance = db.get_balance("alice", SCORUM_SYMBOL);
+
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            transfer_operation op;
+            op.from = TEST_INIT_DELEGATE_NAME;
+            op.to = "alice";
+            op.amount = asset(100 + i, SCORUM_SYMBOL);
+
+            signed_transaction tx;
+            tx.operations.push_back(op);
+            tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(init_account_priv_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+        }
+
+        auto b = db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                   database::skip_nothing);
+
+        BOOST_REQUIRE_EQUAL(b.transactions.size(), 5u);
+        BOOST_CHECK(b.transaction_merkle_root == b.calculate_merkle_root());
+        BOOST_CHECK(db.head_block_id() == b.id());
+        BOOST_CHECK_EQUAL(db.get_mempool_stats().pending, 0u);
+        BOOST_CHECK(db.get_balance("alice", SCORUM_SYMBOL) == alice_balance + asset(510, SCORUM_SYMBOL));
+    }
+    FC_LOG_AND_RETHROW()
+}
+
 BOOST_FIXTURE_TEST_CASE(pop_block_twice, clean_database_fixture)
 {
     try
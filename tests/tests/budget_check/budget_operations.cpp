@@ -230,6 +230,40 @@ SCORUM_TEST_CASE(auto_close_budget_by_deadline)
     BOOST_REQUIRE_NO_THROW(validate_database());
 }
 
+SCORUM_TEST_CASE(close_budget_repays_not_allocated_balance)
+{
+    private_key_type alice_private_key
+        = alice_create_budget(asset(BUDGET_BALANCE_DEFAULT, SCORUM_SYMBOL), time_point_sec::maximum());
+
+    generate_block();
+    generate_block();
+
+    const budget_object& budget = (*budget_service.get_budgets("alice").cbegin());
+
+    const asset rest = budget_service.get_balance(budget);
+
+    BOOST_REQUIRE_EQUAL(rest, budget.balance - asset(budget.per_block * 2, SCORUM_SYMBOL));
+
+    const asset alice_balance = account_service.get_account("alice").balance;
+
+    close_budget_operation close_op;
+    close_op.owner = "alice";
+    close_op.budget_id = budget.id._id;
+
+    signed_transaction tx;
+
+    tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+    tx.operations.push_back(close_op);
+
+    BOOST_REQUIRE_NO_THROW(tx.sign(alice_private_key, db.get_chain_id()));
+    BOOST_REQUIRE_NO_THROW(db.push_transaction(tx, 0));
+
+    BOOST_REQUIRE(budget_service.get_budgets("alice").empty());
+    BOOST_REQUIRE_EQUAL(account_service.get_account("alice").balance, alice_balance + rest);
+
+    BOOST_REQUIRE_NO_THROW(validate_database());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif
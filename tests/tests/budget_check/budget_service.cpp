@@ -51,8 +51,15 @@ public:
                                              authority(),
                                              asset(0, SCORUM_SYMBOL)))
     {
-        account_service.increase_balance(alice, asset(ALICE_ACCOUNT_BUDGET, SCORUM_SYMBOL));
-        account_service.increase_balance(bob, asset(BOB_ACCOUNT_BUDGET, SCORUM_SYMBOL));
+        fund_directly(alice, asset(ALICE_ACCOUNT_BUDGET, SCORUM_SYMBOL));
+        fund_directly(bob, asset(BOB_ACCOUNT_BUDGET, SCORUM_SYMBOL));
+    }
+
+    // balance is moved from the initial delegate, so the supply stays the same
+    void fund_directly(const account_object& account, const asset& amount)
+    {
+        account_service.decrease_balance(account_service.get_account(TEST_INIT_DELEGATE_NAME), amount);
+        account_service.increase_balance(account, amount);
     }
 
     dbs_budget& budget_service;
@@ -303,13 +310,27 @@ SCORUM_TEST_CASE(check_close_budget)
 SCORUM_TEST_CASE(allocate_cash_per_block)
 {
     asset balance(BUDGET_BALANCE_DEFAULT, SCORUM_SYMBOL);
-    time_point_sec deadline(default_deadline);
 
-    const auto& budget = budget_service.create_budget(alice, balance, deadline);
+    const auto& budget = budget_service.create_budget(alice, balance, time_point_sec::maximum());
+
+    BOOST_REQUIRE_EQUAL(budget.per_block, BUDGET_PER_BLOCK_DEFAULT);
+    BOOST_REQUIRE_EQUAL(budget_service.get_balance(budget), balance); // wait next block
 
-    auto cash = budget_service.allocate_cash(budget);
+    generate_block();
 
-    BOOST_REQUIRE_EQUAL(cash.amount, 0); // wait next block
+    // budget object is not modified by allocation
+    BOOST_REQUIRE_EQUAL(budget.balance, balance);
+    BOOST_REQUIRE_EQUAL(budget_service.get_balance(budget).amount, BUDGET_BALANCE_DEFAULT - BUDGET_PER_BLOCK_DEFAULT);
+
+    for (int ci = 1; ci < BUDGET_BALANCE_DEFAULT; ++ci)
+    {
+        BOOST_REQUIRE(!budget_service.get_budgets("alice").empty());
+
+        generate_block();
+    }
+
+    BOOST_REQUIRE(budget_service.get_budgets("alice").empty());
+    BOOST_REQUIRE_EQUAL(db.get_dynamic_global_properties().budgets_per_block.amount, 0);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
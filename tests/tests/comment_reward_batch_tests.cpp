@@ -0,0 +1,104 @@
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/util/reward.hpp>
+
+#include "defines.hpp"
+
+#include <limits>
+#include <vector>
+
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+namespace {
+
+struct comment_reward_batch_fixture
+{
+    comment_reward_batch_fixture()
+    {
+        const int64_t max_rshares = std::numeric_limits<int64_t>::max();
+
+        rshares = { 1, 2, 3, 1000, 123456789, 5000000000, (int64_t)1 << 40, (int64_t)1 << 52, max_rshares / 2,
+                    max_rshares, 0, -100 };
+        for (size_t i = 0; i < rshares.size(); ++i)
+        {
+            weights.push_back(i % 3 ? SCORUM_100_PERCENT : (uint16_t)(SCORUM_100_PERCENT / (i + 2)));
+            max_scr.push_back(i % 4 ? ASSET("1000000.000 SCR") : ASSET("0.010 SCR"));
+        }
+    }
+
+    void check_payouts(const curve_id& curve, const asset& reward_fund)
+    {
+        util::comment_reward_batch batch;
+        batch.reserve(rshares.size());
+        for (size_t i = 0; i < rshares.size(); ++i)
+        {
+            batch.push_back(rshares[i], weights[i], max_scr[i]);
+        }
+
+        fc::uint128_t recent_claims = 1000;
+        fc::uint128_t expected_claims = recent_claims;
+        for (const share_type& r : rshares)
+        {
+            if (r > 0)
+                expected_claims += util::evaluate_reward_curve(r.value, curve);
+        }
+
+        recent_claims += batch.evaluate_claims(curve);
+        BOOST_REQUIRE(recent_claims == expected_claims);
+
+        batch.evaluate_payouts(recent_claims, reward_fund);
+
+        for (size_t i = 0; i < rshares.size(); ++i)
+        {
+            share_type expected = 0;
+            if (rshares[i] > 0)
+            {
+                util::comment_reward_context ctx;
+                ctx.total_reward_shares2 = recent_claims;
+                ctx.total_reward_fund_scorum = reward_fund;
+                ctx.reward_curve = curve;
+                ctx.rshares = rshares[i];
+                ctx.reward_weight = weights[i];
+                ctx.max_scr = max_scr[i];
+
+                expected = util::get_rshare_reward(ctx);
+            }
+
+            BOOST_CHECK_EQUAL(batch.payouts[i].value, expected.value);
+        }
+    }
+
+    std::vector<share_type> rshares;
+    std::vector<uint16_t> weights;
+    std::vector<asset> max_scr;
+};
+}
+
+BOOST_FIXTURE_TEST_SUITE(comment_reward_batch_tests, comment_reward_batch_fixture)
+
+SCORUM_TEST_CASE(payouts_are_equal_to_single_comment_rewards)
+{
+    for (const curve_id curve : { quadratic, linear, square_root, power1dot5 })
+    {
+        check_payouts(curve, ASSET("0.000 SCR"));
+        check_payouts(curve, ASSET("1.000 SCR"));
+        check_payouts(curve, ASSET("100000.000 SCR"));
+        check_payouts(curve, asset(std::numeric_limits<int64_t>::max() / 1000, SCORUM_SYMBOL));
+    }
+}
+
+SCORUM_TEST_CASE(not_positive_rshares_are_not_rewarded)
+{
+    util::comment_reward_batch batch;
+    batch.push_back(0, SCORUM_100_PERCENT, ASSET("1000000.000 SCR"));
+    batch.push_back(-100, SCORUM_100_PERCENT, ASSET("1000000.000 SCR"));
+
+    BOOST_REQUIRE(batch.evaluate_claims(quadratic) == 0);
+
+    BOOST_REQUIRE_NO_THROW(batch.evaluate_payouts(0, ASSET("1.000 SCR")));
+    BOOST_CHECK_EQUAL(batch.payouts[0].value, 0);
+    BOOST_CHECK_EQUAL(batch.payouts[1].value, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
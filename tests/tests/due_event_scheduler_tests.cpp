@@ -0,0 +1,102 @@
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/due_event_scheduler.hpp>
+
+#include "defines.hpp"
+
+#include <map>
+#include <vector>
+
+using namespace scorum::chain;
+
+namespace {
+
+struct due_event_queue
+{
+    std::map<fc::time_point_sec, std::string> events;
+    std::vector<std::string>* log = nullptr;
+
+    void attach(due_event_scheduler& scheduler, due_event_kind kind)
+    {
+        scheduler.set_handler(kind,
+                              [this]() {
+                                  return events.empty() ? fc::optional<fc::time_point_sec>()
+                                                        : fc::optional<fc::time_point_sec>(events.begin()->first);
+                              },
+                              [this]() {
+                                  log->push_back(events.begin()->second);
+                                  events.erase(events.begin());
+                              });
+    }
+};
+
+struct due_event_scheduler_fixture
+{
+    due_event_scheduler_fixture()
+    {
+        for (uint32_t kind = 0; kind < due_event_kinds_count; ++kind)
+        {
+            queues[kind].log = &log;
+            queues[kind].attach(scheduler, (due_event_kind)kind);
+        }
+    }
+
+    due_event_scheduler scheduler;
+    due_event_queue queues[due_event_kinds_count];
+    std::vector<std::string> log;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(due_event_scheduler_tests, due_event_scheduler_fixture)
+
+SCORUM_TEST_CASE(process_only_due_events_in_kind_order)
+{
+    queues[vesting_withdrawal].events[fc::time_point_sec(20)] = "withdrawal 20";
+    queues[vesting_withdrawal].events[fc::time_point_sec(10)] = "withdrawal 10";
+    queues[vesting_withdrawal].events[fc::time_point_sec(30)] = "withdrawal 30";
+    queues[transaction_expiration].events[fc::time_point_sec(25)] = "transaction 25";
+    queues[proposal_expiration].events[fc::time_point_sec(5)] = "proposal 5";
+
+    BOOST_CHECK_EQUAL(scheduler.process(transaction_expiration, proposal_expiration, fc::time_point_sec(20)), 3u);
+
+    std::vector<std::string> expected = { "withdrawal 10", "withdrawal 20", "proposal 5" };
+    BOOST_CHECK(log == expected);
+
+    BOOST_CHECK_EQUAL(scheduler.processed(vesting_withdrawal), 2u);
+    BOOST_CHECK_EQUAL(scheduler.processed(proposal_expiration), 1u);
+    BOOST_CHECK_EQUAL(scheduler.processed(transaction_expiration), 0u);
+    BOOST_CHECK_EQUAL(queues[vesting_withdrawal].events.size(), 1u);
+}
+
+SCORUM_TEST_CASE(process_only_requested_kinds)
+{
+    queues[transaction_expiration].events[fc::time_point_sec(1)] = "transaction 1";
+    queues[vesting_delegation_expiration].events[fc::time_point_sec(1)] = "delegation 1";
+    queues[vesting_withdrawal].events[fc::time_point_sec(1)] = "withdrawal 1";
+
+    BOOST_CHECK_EQUAL(scheduler.process(transaction_expiration, vesting_delegation_expiration, fc::time_point_sec(1)),
+                      2u);
+    BOOST_CHECK_EQUAL(queues[vesting_withdrawal].events.size(), 1u);
+
+    BOOST_CHECK_EQUAL(scheduler.process(vesting_withdrawal, proposal_expiration, fc::time_point_sec(1)), 1u);
+
+    std::vector<std::string> expected = { "transaction 1", "delegation 1", "withdrawal 1" };
+    BOOST_CHECK(log == expected);
+}
+
+SCORUM_TEST_CASE(nothing_is_due_on_empty_queues)
+{
+    BOOST_CHECK_EQUAL(scheduler.process(transaction_expiration, proposal_expiration, fc::time_point_sec::maximum()),
+                      0u);
+    BOOST_CHECK(log.empty());
+}
+
+SCORUM_TEST_CASE(throw_on_missing_handler)
+{
+    due_event_scheduler empty;
+    BOOST_CHECK_THROW(empty.process(transaction_expiration, transaction_expiration, fc::time_point_sec()),
+                      fc::assert_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
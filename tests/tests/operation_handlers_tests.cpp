@@ -0,0 +1,97 @@
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/operation_handlers.hpp>
+
+#include "defines.hpp"
+
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+BOOST_AUTO_TEST_SUITE(operation_handlers_tests)
+
+SCORUM_TEST_CASE(only_handlers_of_operation_type_are_called)
+{
+    operation_handlers handlers;
+
+    std::vector<std::string> voted;
+    uint32_t comments = 0;
+
+    handlers.add<vote_operation>(
+        [&](const vote_operation& op, const operation_notification&) { voted.push_back(op.voter); });
+    handlers.add<comment_operation>([&](const comment_operation&, const operation_notification&) { ++comments; });
+    handlers.add<comment_operation>([&](const comment_operation&, const operation_notification&) { ++comments; });
+
+    vote_operation vote;
+    vote.voter = "alice";
+
+    operation op = vote;
+    handlers(operation_notification(op));
+
+    op = transfer_operation();
+    handlers(operation_notification(op));
+
+    op = comment_operation();
+    handlers(operation_notification(op));
+
+    BOOST_REQUIRE_EQUAL(voted.size(), 1u);
+    BOOST_CHECK_EQUAL(voted[0], "alice");
+    BOOST_CHECK_EQUAL(comments, 2u);
+}
+
+SCORUM_TEST_CASE(masked_handler_is_called_for_operations_in_mask)
+{
+    operation_handlers handlers;
+
+    auto mask = operation_handlers::make_mask<vote_operation, transfer_operation>();
+    BOOST_CHECK_EQUAL(mask.count(), 2u);
+    BOOST_CHECK(mask.test(operation::tag<vote_operation>::value));
+    BOOST_CHECK(mask.test(operation::tag<transfer_operation>::value));
+
+    std::vector<int> notified;
+    handlers.add(mask, [&](const operation_notification& note) { notified.push_back(note.op.which()); });
+
+    for (const operation& op : std::vector<operation>{ vote_operation(), comment_operation(), transfer_operation() })
+    {
+        handlers(operation_notification(op));
+    }
+
+    BOOST_REQUIRE_EQUAL(notified.size(), 2u);
+    BOOST_CHECK_EQUAL(notified[0], (int)operation::tag<vote_operation>::value);
+    BOOST_CHECK_EQUAL(notified[1], (int)operation::tag<transfer_operation>::value);
+}
+
+struct vote_and_transfer_visitor
+{
+    typedef void result_type;
+
+    template <typename T> void operator()(const T&) const
+    {
+    }
+
+    void operator()(const vote_operation&) const
+    {
+    }
+
+    void operator()(const transfer_operation&) const
+    {
+    }
+};
+
+struct comment_visitor
+{
+    typedef void result_type;
+
+    void operator()(const comment_operation&) const
+    {
+    }
+};
+
+SCORUM_TEST_CASE(visitor_mask_follows_visitor_overloads)
+{
+    BOOST_CHECK((operation_handlers::make_visitor_mask<vote_and_transfer_visitor>()
+                 == operation_handlers::make_mask<vote_operation, transfer_operation>()));
+    BOOST_CHECK((operation_handlers::make_visitor_mask<comment_visitor>()
+                 == operation_handlers::make_mask<comment_operation>()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
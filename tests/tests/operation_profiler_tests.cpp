@@ -0,0 +1,63 @@
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/operation_profiler.hpp>
+
+#include "defines.hpp"
+
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+namespace {
+
+struct operation_profiler_fixture
+{
+    void record(const operation& op, int64_t evaluate_ns)
+    {
+        profiler.record(op, std::chrono::nanoseconds(10), std::chrono::nanoseconds(evaluate_ns),
+                        std::chrono::nanoseconds(20));
+    }
+
+    operation_profiler profiler;
+};
+}
+
+BOOST_FIXTURE_TEST_SUITE(operation_profiler_tests, operation_profiler_fixture)
+
+SCORUM_TEST_CASE(operations_are_profiled_by_type)
+{
+    for (int i = 1; i <= 100; ++i)
+    {
+        record(vote_operation(), 100);
+    }
+    record(vote_operation(), 5000);
+    record(comment_operation(), 100000);
+
+    auto profiles = profiler.get_profiles();
+    BOOST_REQUIRE_EQUAL(profiles.size(), 2u);
+
+    BOOST_CHECK_EQUAL(profiles[0].name, "comment");
+    BOOST_CHECK_EQUAL(profiles[0].count, 1u);
+    BOOST_CHECK_EQUAL(profiles[0].total_ns, 100000u);
+    BOOST_CHECK_EQUAL(profiles[0].p99_ns, 100000u);
+
+    BOOST_CHECK_EQUAL(profiles[1].name, "vote");
+    BOOST_CHECK_EQUAL(profiles[1].count, 101u);
+    BOOST_CHECK_EQUAL(profiles[1].total_ns, 15000u);
+    BOOST_CHECK_EQUAL(profiles[1].avg_ns, 148u);
+    BOOST_CHECK_EQUAL(profiles[1].max_ns, 5000u);
+    BOOST_CHECK_EQUAL(profiles[1].pre_notify_ns, 1010u);
+    BOOST_CHECK_EQUAL(profiles[1].post_notify_ns, 2020u);
+
+    // 100 is in the [64, 128) bucket
+    BOOST_CHECK_EQUAL(profiles[1].p99_ns, 128u);
+}
+
+SCORUM_TEST_CASE(reset_drops_profiles)
+{
+    record(vote_operation(), 100);
+    profiler.reset();
+
+    BOOST_CHECK(profiler.get_profiles().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
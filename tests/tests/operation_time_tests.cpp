@@ -1744,5 +1744,112 @@ BOOST_AUTO_TEST_CASE(comment_freeze)
     FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE(curation_of_many_comments_paid_in_one_block)
+{
+    try
+    {
+        BOOST_TEST_MESSAGE("Testing: curation rewards of comments cashed out in the same block");
+
+        // enough comments for curation rewards to be split in parallel
+        const uint32_t authors = 16;
+
+        std::vector<std::string> names;
+        std::vector<fc::ecc::private_key> keys;
+        for (uint32_t i = 0; i < authors; ++i)
+        {
+            names.push_back("user" + std::to_string(i));
+            keys.push_back(generate_private_key(names.back()));
+            account_create(names.back(), keys.back().get_public_key(), keys.back().get_public_key());
+            fund(names.back(), 10000);
+            vest(names.back(), 10000);
+        }
+
+        for (uint32_t i = 0; i < authors; ++i)
+        {
+            comment_operation comment;
+            comment.author = names[i];
+            comment.permlink = "test";
+            comment.parent_permlink = "test";
+            comment.title = "foo";
+            comment.body = "bar";
+
+            signed_transaction tx;
+            tx.operations.push_back(comment);
+            tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(keys[i], db.get_chain_id());
+            db.push_transaction(tx, 0);
+        }
+
+        generate_blocks(db.head_block_time() + SCORUM_REVERSE_AUCTION_WINDOW_SECONDS);
+
+        for (uint32_t i = 0; i < authors; ++i)
+        {
+            vote_operation vote;
+            vote.voter = names[i];
+            vote.author = names[(i + 1) % authors];
+            vote.permlink = "test";
+            vote.weight = SCORUM_100_PERCENT;
+
+            signed_transaction tx;
+            tx.operations.push_back(vote);
+            tx.set_expiration(db.head_block_time() + SCORUM_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(keys[i], db.get_chain_id());
+            db.push_transaction(tx, 0);
+        }
+
+        const fc::time_point_sec cashout_time = db.get_comment(names[0], std::string("test")).cashout_time;
+        generate_blocks(cashout_time - SCORUM_BLOCK_INTERVAL);
+        BOOST_REQUIRE(db.head_block_time() < cashout_time);
+
+        std::vector<share_type> curation_rewards_before;
+        for (uint32_t i = 0; i < authors; ++i)
+        {
+            curation_rewards_before.push_back(db.get_account(names[i]).curation_rewards);
+        }
+
+        generate_block();
+
+        // every voter votes for one comment, so the change of its curation rewards is its claim
+        std::map<account_id_type, share_type> claims;
+        std::vector<share_type> reward_tokens;
+        share_type curator_payouts = 0;
+        for (uint32_t i = 0; i < authors; ++i)
+        {
+            const auto& comment = db.get_comment(names[i], std::string("test"));
+            BOOST_REQUIRE(comment.last_payout == db.head_block_time());
+            curator_payouts += comment.curator_payout_value.amount;
+            reward_tokens.push_back(comment.total_payout_value.amount + comment.curator_payout_value.amount
+                                    + comment.beneficiary_payout_value.amount);
+
+            const auto& voter = db.get_account(names[i]);
+            claims[voter.id] = voter.curation_rewards - curation_rewards_before[i];
+        }
+
+        BOOST_REQUIRE_GT(curator_payouts.value, 0);
+
+        BOOST_TEST_MESSAGE("--- Test claims split in parallel match claims split serially before the cashout");
+        db.pop_block();
+
+        share_type curation_rewards = 0;
+        for (uint32_t i = 0; i < authors; ++i)
+        {
+            const auto& comment = db.get_comment(names[i], std::string("test"));
+            share_type curation_tokens
+                = ((fc::uint128_t(reward_tokens[i].value) * SCORUM_CURATION_REWARD_PERCENT) / SCORUM_100_PERCENT)
+                      .to_uint64();
+
+            auto expected = db.get_curator_claims(comment, curation_tokens);
+            BOOST_REQUIRE_EQUAL(expected.size(), 1u);
+            BOOST_CHECK_EQUAL(claims[expected[0].first].value, expected[0].second.value);
+            curation_rewards += expected[0].second;
+        }
+
+        BOOST_CHECK_EQUAL(curator_payouts.value, curation_rewards.value);
+
+        validate_database();
+    }
+    FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
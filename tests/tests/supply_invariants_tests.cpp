@@ -0,0 +1,57 @@
+#ifdef IS_TEST_NET
+#include <boost/test/unit_test.hpp>
+
+#include <scorum/chain/schema/account_objects.hpp>
+#include <scorum/chain/schema/dynamic_global_property_object.hpp>
+
+#include "database_fixture.hpp"
+
+using namespace scorum;
+using namespace scorum::chain;
+using namespace scorum::protocol;
+
+BOOST_FIXTURE_TEST_SUITE(supply_invariants_tests, clean_database_fixture)
+
+SCORUM_TEST_CASE(running_totals_follow_balance_changes)
+{
+    ACTORS((alice)(bob))
+
+    fund("alice", 1000);
+    vest("alice", 500);
+    transfer("alice", "bob", ASSET("0.100 SCR"));
+
+    BOOST_REQUIRE_NO_THROW(db.validate_invariants());
+    BOOST_REQUIRE_NO_THROW(db.audit_invariants());
+}
+
+SCORUM_TEST_CASE(invariants_are_checked_every_block)
+{
+    ACTORS((alice))
+
+    fund("alice", 1000);
+
+    BOOST_REQUIRE_EQUAL(db_plugin->debug_generate_blocks(debug_key, 10, default_skip, 0), 10u);
+
+    db.modify(db.get_dynamic_global_properties(),
+              [&](dynamic_global_property_object& props) { props.total_accounts_balance += ASSET("0.001 SCR"); });
+
+    BOOST_REQUIRE_THROW(db.validate_invariants(), fc::exception);
+    BOOST_REQUIRE_THROW(db_plugin->debug_generate_blocks(debug_key, 1, default_skip, 0), fc::exception);
+}
+
+SCORUM_TEST_CASE(audit_detects_untracked_balance_change)
+{
+    ACTORS((alice))
+
+    fund("alice", 1000);
+
+    // balance is changed bypassing the services, running totals do not see it
+    db.modify(alice, [&](account_object& a) { a.balance += ASSET("0.001 SCR"); });
+
+    BOOST_REQUIRE_NO_THROW(db.validate_invariants());
+    BOOST_REQUIRE_THROW(db.audit_invariants(), fc::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
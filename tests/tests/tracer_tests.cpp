@@ -0,0 +1,122 @@
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+#include <graphene/utilities/tracer.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include "defines.hpp"
+
+#include <cstring>
+
+using graphene::utilities::trace_event;
+using graphene::utilities::tracer;
+
+namespace {
+
+// spans of trace_scope are recorded to the process wide tracer, it must not stay enabled for other tests
+struct instance_tracer_fixture
+{
+    instance_tracer_fixture()
+    {
+        tracer::instance().start(1024, graphene::utilities::temp_directory_path());
+    }
+
+    ~instance_tracer_fixture()
+    {
+        tracer::instance().stop();
+    }
+};
+}
+
+BOOST_AUTO_TEST_SUITE(tracer_tests)
+
+SCORUM_TEST_CASE(nothing_is_recorded_until_started)
+{
+    tracer t;
+    t.record("span", "test", 1, 1);
+
+    BOOST_CHECK(!t.enabled());
+    BOOST_CHECK(t.get_events().empty());
+}
+
+SCORUM_TEST_CASE(oldest_spans_are_overwritten)
+{
+    tracer t;
+    t.start(4, graphene::utilities::temp_directory_path());
+
+    for (uint64_t i = 0; i < 6; ++i)
+    {
+        t.record("span", "test", 100 + i, 10, i);
+    }
+
+    std::vector<trace_event> events = t.get_events();
+    BOOST_REQUIRE_EQUAL(events.size(), 4u);
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(std::strcmp(events[i].name, "span"), 0);
+        BOOST_CHECK_EQUAL(events[i].value, i + 2);
+        BOOST_CHECK_EQUAL(events[i].start_us, 102 + i);
+    }
+}
+
+SCORUM_TEST_CASE(chrome_trace_is_valid_json)
+{
+    tracer t;
+    t.start(16, graphene::utilities::temp_directory_path());
+
+    t.record("apply_block", "chain", 100, 50, 7);
+    t.record("apply_transaction", "chain", 110, 20, 0);
+
+    fc::path file = t.dump("tracer_test");
+
+    fc::variant_object trace = fc::json::from_file(file).get_object();
+    auto events = trace["traceEvents"].get_array();
+    BOOST_REQUIRE_EQUAL(events.size(), 2u);
+
+    auto block = events[0].get_object();
+    BOOST_CHECK_EQUAL(block["name"].as_string(), "apply_block");
+    BOOST_CHECK_EQUAL(block["ph"].as_string(), "X");
+    BOOST_CHECK_EQUAL(block["ts"].as_uint64(), 100u);
+    BOOST_CHECK_EQUAL(block["dur"].as_uint64(), 50u);
+
+    fc::remove(file);
+}
+
+BOOST_FIXTURE_TEST_CASE(dump_is_written_after_open_scopes_close, instance_tracer_fixture)
+{
+    try
+    {
+        tracer& t = tracer::instance();
+
+        fc::path file = graphene::utilities::temp_directory_path() / "tracer_scope_test.json";
+        fc::remove_all(file);
+
+        {
+            graphene::utilities::trace_scope outer("handle_block", "test");
+            {
+                graphene::utilities::trace_scope inner("push_block", "test");
+                t.dump_after_scopes("tracer_scope_test");
+            }
+
+            t.wait_for_dumps();
+            BOOST_CHECK(!fc::exists(file));
+        }
+
+        t.wait_for_dumps();
+        BOOST_REQUIRE(fc::exists(file));
+
+        bool has_outer = false;
+        for (const auto& e : fc::json::from_file(file).get_object()["traceEvents"].get_array())
+        {
+            has_outer |= e.get_object()["name"].as_string() == "handle_block";
+        }
+        BOOST_CHECK(has_outer);
+
+        fc::remove(file);
+    }
+    FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()